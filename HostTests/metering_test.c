@@ -0,0 +1,152 @@
+//*********************************************************************************
+//**
+//** Host test of the FAST_METERING arithmetic, runs on the PC, not on the Mobo
+//**
+//** cc -O2 -o metering_test HostTests/metering_test.c -lm && ./metering_test
+//**
+//** Checks Mobo_Metering.h, the same code as used by the firmware with FAST_METERING
+//** (PWR_CAL_TABLE off), against the exact formula and the divisions
+//**
+//** Every 16 bit AD7991 value is checked, ADC_DECIMATE sums of up to 16 readings
+//** are not multiples of 16 like the single 12 bit (MSB aligned) readings.
+//** Returns 0 if all is well, 1 and a list of the failures otherwise
+//**
+//*********************************************************************************
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "../Mobo_Metering.h"
+
+#define POWER_ERR_MAX	0.57					// Largest error allowed, in mW
+
+struct
+{
+	uint16_t	PWR_Calibrate;
+	uint16_t	P_Min_Trigger;
+} R;
+
+uint32_t	meter_k;
+uint16_t	meter_v_max;
+uint16_t	meter_trigger;
+
+// As measured_Power(), meter_update() and its trigger test in Mobo_Pwr_SWR_and_Bias_cal.c
+uint16_t measured_Power(uint16_t voltage)
+{
+	return meter_power(voltage, meter_k, meter_v_max);
+}
+
+static uint8_t meter_above_trigger(uint16_t voltage)
+{
+	return measured_Power(voltage) > R.P_Min_Trigger;
+}
+
+void meter_update(void)
+{
+	meter_k = meter_k_of(R.PWR_Calibrate);
+	meter_v_max = meter_v_max_of(meter_k);
+	meter_trigger = meter_search(meter_above_trigger);
+}
+
+// The formula of the divisions version, without rounding or overflow
+double exact_Power(uint16_t voltage)
+{
+	double x;
+
+	if (voltage > 0) voltage = voltage/0x10 + 82;
+	x = (double)voltage * R.PWR_Calibrate / 84;
+	return x * x / 50000;
+}
+
+// The divisions version, in 64 bits, for the comparison only
+uint64_t old_Power(uint16_t voltage)
+{
+	uint64_t p;
+
+	if (voltage > 0) voltage = voltage/0x10 + 82;
+	p = (uint64_t)voltage * R.PWR_Calibrate/84;
+	return (p*p)/50000;
+}
+
+static unsigned long	fails;
+
+static void fail(const char *what, uint32_t cal, uint32_t adc, double a, double b)
+{
+	if (fails++ < 20)
+		printf("FAIL %s: cal %lu, adc %lu, %.3f / %.3f\n", what,
+			(unsigned long)cal, (unsigned long)adc, a, b);
+}
+
+int main(void)
+{
+	uint32_t	adc, cal, trig;
+	double		err, err_max = 0, old_max = 0;
+	unsigned long worse = 0;
+
+	// Voltage and current, same as the divisions for every 16 bit value
+	for (adc = 0; adc <= 0xffff; adc++)
+	{
+		if (AD7991_VOLT_X10_MUL(adc) != AD7991_VOLT_X10_DIV(adc))
+			fail("VOLT", 0, adc, AD7991_VOLT_X10_MUL(adc), AD7991_VOLT_X10_DIV(adc));
+		if (AD7991_AMP_X100_MUL(adc) != AD7991_AMP_X100_DIV(adc))
+			fail("AMP", 0, adc, AD7991_AMP_X100_MUL(adc), AD7991_AMP_X100_DIV(adc));
+	}
+
+	// Power, against the exact formula, over every 16 bit value
+	for (cal = 1; cal <= 0xffff; cal += (cal < 4000) ? 1 : 61)
+	{
+		uint16_t p, last = 0;
+
+		R.PWR_Calibrate = cal;
+		R.P_Min_Trigger = 0;
+		meter_update();
+		for (adc = 0; adc <= 0xffff; adc++)
+		{
+			double e = exact_Power(adc);
+
+			p = measured_Power(adc);
+			if (p < last)
+				fail("monotonic", cal, adc, p, last);
+			last = p;
+			if (e >= 65535.5)
+			{
+				if (p != 0xffff)
+					fail("saturate", cal, adc, p, e);
+				continue;
+			}
+			err = fabs(p - e);
+			if (err > POWER_ERR_MAX)
+				fail("power", cal, adc, p, e);
+			if (err > err_max) err_max = err;
+			if (e <= 65535)
+			{
+				double old = fabs((double)old_Power(adc) - e);
+
+				if (old > old_max) old_max = old;
+				if (err > old) worse++;
+			}
+		}
+	}
+
+	// Trigger, reading > meter_trigger the same as power > R.P_Min_Trigger
+	for (cal = 100; cal <= 5000; cal += 149)
+	{
+		for (trig = 0; trig <= 0xffff; trig = trig * 3 + 1)
+		{
+			R.PWR_Calibrate = cal;
+			R.P_Min_Trigger = trig;
+			meter_update();
+			for (adc = 0; adc <= 0xffff; adc++)
+			{
+				if ((adc > meter_trigger) != (measured_Power(adc) > trig))
+					fail("trigger", cal, adc, meter_trigger, trig);
+			}
+		}
+	}
+
+	printf("Power error max %.3fmW (divisions %.3fmW), %lu readings worse than the divisions\n",
+		err_max, old_max, worse);
+	printf("%s, %lu failures\n", fails ? "FAILED" : "PASSED", fails);
+	return fails ? 1 : 0;
+}
@@ -332,6 +332,10 @@
 #define ENCODER_INT_STYLE	0	// Interrupt driven Rotary Encoder VFO, uses one interrupt, gives
 								// only half the resolution of the encoder (every other click inactive)
 								//(Cost 652 bytes)
+#define ENCODER_INT_TABLE	0	// Used with ENCODER_INT_STYLE.  Interrupt on both phases (INT6 on Phase A,
+								// pin change interrupt PCINT12 on Phase B) with a table driven decoder.
+								// Gives full resolution of the encoder. Invalid transitions are counted
+								// and can be read through USB Cmd 0x69
 
 // It makes little sense to have both of the two below enabled at the same time.
 #define ENCODER_CMD_INCR	0	// USB Cmd 0x36. Modify Encoder Resolution, 32 bit signed integer.
@@ -344,6 +348,102 @@
 #define ENCODER_DIR_SENSE	0	// Direction change sense.  Used with variable speed feature.
 								// Direction change drops immediately out of fast speed mode
 								// (cost 42 bytes)
+#define ENCODER_ACCEL	0	// Used with ENCODER_INT_STYLE.  Velocity based acceleration curve, the step
+								// size follows the encoder speed, measured between encoder pulses.
+								// Replaces ENCODER_FAST_ENABLE.  Curve is read/modified with USB Cmd 0x6a
+#define ENCODER_FAST_RETUNE	0	// Used with ENCODER_INT_STYLE.  Write encoder frequency changes to the Si570
+								// on the next mainloop pass rather than in the 10ms slot, at most once
+								// per ENC_RETUNE_MIN.  Retune latency can be read through USB Cmd 0x69
+
+//-----------------------------------------------------------------------------
+// USB command handling
+//
+#define USB_DEFERRED_CMD	0	// Defer EEPROM writes and I2C traffic caused by USB commands to the
+								// mainloop.  The USB control request is answered immediately, using
+								// cached values where possible (Cmd 0x3f returns the Si570 registers
+								// last written, rather than reading them back from the chip)
+								// (Uses 32 bytes of RAM for the command queue)
+
+#define USB_TELEMETRY	0	// Interrupt IN endpoint (EP1) streaming a telemetry record with the ADC
+								// inputs, temperature, SWR, status flags and frequency.  Interval set
+								// with USB Cmd 0x63, default 100ms during RX and 10ms during TX
+
+#define USB_SNAPSHOT_CMD	0	// USB Cmd 0x62.  Read a consistent snapshot of all ADC inputs, temperature,
+								// SWR, power, selected filters and status flags in a single transfer.
+								// Double buffered, updated every 10ms (Uses 52 bytes of RAM)
+
+#define USB_CONFIG_IMAGE	0	// USB Cmd 0x37, 0x44 and 0x45.  Dump and restore the whole EEPROM settings
+								// image in chunks, with a CRC check before a restored image is used
+
+#define USB_BATCH_CMD		0	// USB Cmd 0x38 and 0x46.  Execute a batch of sub-commands (e.g. set frequency,
+								// set PTT and read the CW key state) in a single OUT transfer of up to
+								// 24 bytes, the concatenated results are read back with Cmd 0x46
+								// (Uses 33 bytes of RAM)
+
+#define USB_TIMED_FREQ		0	// USB Cmd 0x48 and 0x49.  Write a new frequency to the Si570 when the USB
+								// frame number reaches a given value, and report the frame number
+								// in which it was written, for retunes aligned with the audio stream
+
+#define USB_HOP_LIST		0	// USB Cmd 0x4a and 0x4b.  Step through a list of up to HOP_LIST_LEN frequencies,
+								// each with its own dwell time in ms, timed by the firmware rather
+								// than by the host (Uses 60 bytes of RAM)
+
+#define SWR_SWEEP		0	// USB Cmd 0x4c, 0x4d and 0x4e.  SWR sweep, the firmware steps through a range
+								// of frequencies with the transmitter keyed, measuring SWR at each
+								// point.  Used with POWER_SWR (Uses 120 bytes of RAM)
+
+#define CW_KEY_EVENTS		0	// USB Cmd 0x52.  Pin change interrupt on the CW key inputs.  Debounced CW key
+								// and PTT edges are timestamped and queued, to be read with Cmd 0x52
+								// rather than polling Cmd 0x51 (Uses 56 bytes of RAM)
+
+#define CW_KEYER		0	// USB Cmd 0x53.  Iambic A/B keyer, timed by a 1ms Timer1 compare interrupt.
+								// Paddles on the CW key inputs, PTT through the Mobo PCF or IO_PTT.
+								// Key down is reported in Cmd 0x51 bit 7 (and Cmd 0x52 edges)
+
+#define TR_SEQUENCER		0	// USB Cmd 0x54 and 0x55.  T/R sequencer, PTT from Cmd 0x50 (and the keyer)
+								// switches RX mute, antenna relay, PTT, bias and PTT2 in order, with a
+								// configurable delay before each step, and the reverse for RX
+
+#define FAST_METERING		0	// Power, voltage and current readings by multiply and shift, with constants
+								// worked out when the calibration values are changed, rather than
+								// by divisions on every reading
+
+#define SWR_FAST_TRIP		0	// USB Cmd 0x56.  Fast SWR trip, used with SWR_ALARM_FUNC.  During TX, the
+								// AD7991 is polled every 2.5ms, and PTT2 and the bias fallback are set
+								// after a configurable number of samples over the SWR threshold
+
+#define PEP_METER		0	// USB Cmd 0x57.  PEP, average and peak hold power metering, used with POWER_SWR.
+								// Updated on every 10ms AD7991 reading, at a constant cost per sample, and
+								// also used by the LCD PEP indication (PWR_PEAK_ENVELOPE)
+
+#define BIAS_FAST_CAL		0	// USB Cmd 0x58.  PA bias calibration by successive approximation, both bias
+								// settings are found in ~16 steps, with a settle time before each reading,
+								// rather than by stepping the bias DAC up one count every 10ms
+
+#define ADC_DECIMATE		0	// USB Cmd 0x59.  Accumulate and dump (boxcar) filter of the AD7991 readings,
+								// 1 - 16 readings per channel are summed into each value of ad7991_adc[],
+								// which then carries up to 16 bits instead of 12
+
+#define PWR_CAL_TABLE		0	// USB Cmds 0x4f, 0x5a and 0x5b.  Power meter calibration table, used with
+								// POWER_SWR.  Up to 16 (AD reading, mW) points for each of 4 bands, loaded
+								// by the host and interpolated, with a 32 bit power reading
+								// (Uses 96 bytes of RAM for the band table in use)
+
+#define LCD_FRAMEBUFFER		0	// Parallel LCD frame buffer.  The display routines write into a RAM image of the
+								// display, and only the characters which have changed are sent to the LCD,
+								// once per pass of maintask().  Costs ~100 bytes of RAM with a 20x4 display
+
+#define LCD_BACKGROUND		0	// Used with LCD_FRAMEBUFFER.  The frame buffer is sent to the LCD one character
+								// or command per pass of maintask(), when the LCD is not busy, rather than by
+								// waiting on the LCD busy flag.  Changes are sent within LCD_FLUSH_DEADLINE
+
+#define LCD_I2C_BATCH		0	// Used with LCD_I2C_DISPLAY.  Characters and cursor commands for the I2C LCD are
+								// collected, and sent as one I2C transaction at the end of each pass of
+								// maintask(), rather than one transaction for each character
+
+#define BARGRAPH_FAST		0	// LCD bargraphs drawn by changes.  The pixel scale is worked out when the
+								// full scale is changed, rather than by a 32 bit division on each reading,
+								// and only the bargraph characters which have changed are written
 
 //-----------------------------------------------------------------------------
 // Debug stuff, do not use
@@ -587,6 +687,10 @@
 #define ENCODER_INT_STYLE	0	// Interrupt driven Rotary Encoder VFO, uses one interrupt, gives
 								// only half the resolution of the encoder (every other click inactive)
 								//(Cost 652 bytes)
+#define ENCODER_INT_TABLE	0	// Used with ENCODER_INT_STYLE.  Interrupt on both phases (INT6 on Phase A,
+								// pin change interrupt PCINT12 on Phase B) with a table driven decoder.
+								// Gives full resolution of the encoder. Invalid transitions are counted
+								// and can be read through USB Cmd 0x69
 
 // It makes little sense to have both of the two below enabled at the same time.
 #define ENCODER_CMD_INCR	0	// USB Cmd 0x36. Modify Encoder Resolution, 32 bit signed integer.
@@ -599,6 +703,102 @@
 #define ENCODER_DIR_SENSE	0	// Direction change sense.  Used with variable speed feature.
 								// Direction change drops immediately out of fast speed mode
 								// (cost 42 bytes)
+#define ENCODER_ACCEL	0	// Used with ENCODER_INT_STYLE.  Velocity based acceleration curve, the step
+								// size follows the encoder speed, measured between encoder pulses.
+								// Replaces ENCODER_FAST_ENABLE.  Curve is read/modified with USB Cmd 0x6a
+#define ENCODER_FAST_RETUNE	0	// Used with ENCODER_INT_STYLE.  Write encoder frequency changes to the Si570
+								// on the next mainloop pass rather than in the 10ms slot, at most once
+								// per ENC_RETUNE_MIN.  Retune latency can be read through USB Cmd 0x69
+
+//-----------------------------------------------------------------------------
+// USB command handling
+//
+#define USB_DEFERRED_CMD	0	// Defer EEPROM writes and I2C traffic caused by USB commands to the
+								// mainloop.  The USB control request is answered immediately, using
+								// cached values where possible (Cmd 0x3f returns the Si570 registers
+								// last written, rather than reading them back from the chip)
+								// (Uses 32 bytes of RAM for the command queue)
+
+#define USB_TELEMETRY	0	// Interrupt IN endpoint (EP1) streaming a telemetry record with the ADC
+								// inputs, temperature, SWR, status flags and frequency.  Interval set
+								// with USB Cmd 0x63, default 100ms during RX and 10ms during TX
+
+#define USB_SNAPSHOT_CMD	0	// USB Cmd 0x62.  Read a consistent snapshot of all ADC inputs, temperature,
+								// SWR, power, selected filters and status flags in a single transfer.
+								// Double buffered, updated every 10ms (Uses 52 bytes of RAM)
+
+#define USB_CONFIG_IMAGE	0	// USB Cmd 0x37, 0x44 and 0x45.  Dump and restore the whole EEPROM settings
+								// image in chunks, with a CRC check before a restored image is used
+
+#define USB_BATCH_CMD		0	// USB Cmd 0x38 and 0x46.  Execute a batch of sub-commands (e.g. set frequency,
+								// set PTT and read the CW key state) in a single OUT transfer of up to
+								// 24 bytes, the concatenated results are read back with Cmd 0x46
+								// (Uses 33 bytes of RAM)
+
+#define USB_TIMED_FREQ		0	// USB Cmd 0x48 and 0x49.  Write a new frequency to the Si570 when the USB
+								// frame number reaches a given value, and report the frame number
+								// in which it was written, for retunes aligned with the audio stream
+
+#define USB_HOP_LIST		0	// USB Cmd 0x4a and 0x4b.  Step through a list of up to HOP_LIST_LEN frequencies,
+								// each with its own dwell time in ms, timed by the firmware rather
+								// than by the host (Uses 60 bytes of RAM)
+
+#define SWR_SWEEP		0	// USB Cmd 0x4c, 0x4d and 0x4e.  SWR sweep, the firmware steps through a range
+								// of frequencies with the transmitter keyed, measuring SWR at each
+								// point.  Used with POWER_SWR (Uses 120 bytes of RAM)
+
+#define CW_KEY_EVENTS		0	// USB Cmd 0x52.  Pin change interrupt on the CW key inputs.  Debounced CW key
+								// and PTT edges are timestamped and queued, to be read with Cmd 0x52
+								// rather than polling Cmd 0x51 (Uses 56 bytes of RAM)
+
+#define CW_KEYER		0	// USB Cmd 0x53.  Iambic A/B keyer, timed by a 1ms Timer1 compare interrupt.
+								// Paddles on the CW key inputs, PTT through the Mobo PCF or IO_PTT.
+								// Key down is reported in Cmd 0x51 bit 7 (and Cmd 0x52 edges)
+
+#define TR_SEQUENCER		0	// USB Cmd 0x54 and 0x55.  T/R sequencer, PTT from Cmd 0x50 (and the keyer)
+								// switches RX mute, antenna relay, PTT, bias and PTT2 in order, with a
+								// configurable delay before each step, and the reverse for RX
+
+#define FAST_METERING		0	// Power, voltage and current readings by multiply and shift, with constants
+								// worked out when the calibration values are changed, rather than
+								// by divisions on every reading
+
+#define SWR_FAST_TRIP		0	// USB Cmd 0x56.  Fast SWR trip, used with SWR_ALARM_FUNC.  During TX, the
+								// AD7991 is polled every 2.5ms, and PTT2 and the bias fallback are set
+								// after a configurable number of samples over the SWR threshold
+
+#define PEP_METER		0	// USB Cmd 0x57.  PEP, average and peak hold power metering, used with POWER_SWR.
+								// Updated on every 10ms AD7991 reading, at a constant cost per sample, and
+								// also used by the LCD PEP indication (PWR_PEAK_ENVELOPE)
+
+#define BIAS_FAST_CAL		0	// USB Cmd 0x58.  PA bias calibration by successive approximation, both bias
+								// settings are found in ~16 steps, with a settle time before each reading,
+								// rather than by stepping the bias DAC up one count every 10ms
+
+#define ADC_DECIMATE		0	// USB Cmd 0x59.  Accumulate and dump (boxcar) filter of the AD7991 readings,
+								// 1 - 16 readings per channel are summed into each value of ad7991_adc[],
+								// which then carries up to 16 bits instead of 12
+
+#define PWR_CAL_TABLE		0	// USB Cmds 0x4f, 0x5a and 0x5b.  Power meter calibration table, used with
+								// POWER_SWR.  Up to 16 (AD reading, mW) points for each of 4 bands, loaded
+								// by the host and interpolated, with a 32 bit power reading
+								// (Uses 96 bytes of RAM for the band table in use)
+
+#define LCD_FRAMEBUFFER		0	// Parallel LCD frame buffer.  The display routines write into a RAM image of the
+								// display, and only the characters which have changed are sent to the LCD,
+								// once per pass of maintask().  Costs ~100 bytes of RAM with a 20x4 display
+
+#define LCD_BACKGROUND		0	// Used with LCD_FRAMEBUFFER.  The frame buffer is sent to the LCD one character
+								// or command per pass of maintask(), when the LCD is not busy, rather than by
+								// waiting on the LCD busy flag.  Changes are sent within LCD_FLUSH_DEADLINE
+
+#define LCD_I2C_BATCH		0	// Used with LCD_I2C_DISPLAY.  Characters and cursor commands for the I2C LCD are
+								// collected, and sent as one I2C transaction at the end of each pass of
+								// maintask(), rather than one transaction for each character
+
+#define BARGRAPH_FAST		0	// LCD bargraphs drawn by changes.  The pixel scale is worked out when the
+								// full scale is changed, rather than by a 32 bit division on each reading,
+								// and only the bargraph characters which have changed are written
 
 //-----------------------------------------------------------------------------
 // Debug stuff, do not use
@@ -842,6 +1042,10 @@
 #define ENCODER_INT_STYLE	0	// Interrupt driven Rotary Encoder VFO, uses one interrupt, gives
 								// only half the resolution of the encoder (every other click inactive)
 								//(Cost 652 bytes)
+#define ENCODER_INT_TABLE	0	// Used with ENCODER_INT_STYLE.  Interrupt on both phases (INT6 on Phase A,
+								// pin change interrupt PCINT12 on Phase B) with a table driven decoder.
+								// Gives full resolution of the encoder. Invalid transitions are counted
+								// and can be read through USB Cmd 0x69
 
 // It makes little sense to have both of the two below enabled at the same time.
 #define ENCODER_CMD_INCR	0	// USB Cmd 0x36. Modify Encoder Resolution, 32 bit signed integer.
@@ -854,6 +1058,102 @@
 #define ENCODER_DIR_SENSE	1	// Direction change sense.  Used with variable speed feature.
 								// Direction change drops immediately out of fast speed mode
 								// (cost 42 bytes)
+#define ENCODER_ACCEL	0	// Used with ENCODER_INT_STYLE.  Velocity based acceleration curve, the step
+								// size follows the encoder speed, measured between encoder pulses.
+								// Replaces ENCODER_FAST_ENABLE.  Curve is read/modified with USB Cmd 0x6a
+#define ENCODER_FAST_RETUNE	0	// Used with ENCODER_INT_STYLE.  Write encoder frequency changes to the Si570
+								// on the next mainloop pass rather than in the 10ms slot, at most once
+								// per ENC_RETUNE_MIN.  Retune latency can be read through USB Cmd 0x69
+
+//-----------------------------------------------------------------------------
+// USB command handling
+//
+#define USB_DEFERRED_CMD	0	// Defer EEPROM writes and I2C traffic caused by USB commands to the
+								// mainloop.  The USB control request is answered immediately, using
+								// cached values where possible (Cmd 0x3f returns the Si570 registers
+								// last written, rather than reading them back from the chip)
+								// (Uses 32 bytes of RAM for the command queue)
+
+#define USB_TELEMETRY	0	// Interrupt IN endpoint (EP1) streaming a telemetry record with the ADC
+								// inputs, temperature, SWR, status flags and frequency.  Interval set
+								// with USB Cmd 0x63, default 100ms during RX and 10ms during TX
+
+#define USB_SNAPSHOT_CMD	0	// USB Cmd 0x62.  Read a consistent snapshot of all ADC inputs, temperature,
+								// SWR, power, selected filters and status flags in a single transfer.
+								// Double buffered, updated every 10ms (Uses 52 bytes of RAM)
+
+#define USB_CONFIG_IMAGE	0	// USB Cmd 0x37, 0x44 and 0x45.  Dump and restore the whole EEPROM settings
+								// image in chunks, with a CRC check before a restored image is used
+
+#define USB_BATCH_CMD		0	// USB Cmd 0x38 and 0x46.  Execute a batch of sub-commands (e.g. set frequency,
+								// set PTT and read the CW key state) in a single OUT transfer of up to
+								// 24 bytes, the concatenated results are read back with Cmd 0x46
+								// (Uses 33 bytes of RAM)
+
+#define USB_TIMED_FREQ		0	// USB Cmd 0x48 and 0x49.  Write a new frequency to the Si570 when the USB
+								// frame number reaches a given value, and report the frame number
+								// in which it was written, for retunes aligned with the audio stream
+
+#define USB_HOP_LIST		0	// USB Cmd 0x4a and 0x4b.  Step through a list of up to HOP_LIST_LEN frequencies,
+								// each with its own dwell time in ms, timed by the firmware rather
+								// than by the host (Uses 60 bytes of RAM)
+
+#define SWR_SWEEP		0	// USB Cmd 0x4c, 0x4d and 0x4e.  SWR sweep, the firmware steps through a range
+								// of frequencies with the transmitter keyed, measuring SWR at each
+								// point.  Used with POWER_SWR (Uses 120 bytes of RAM)
+
+#define CW_KEY_EVENTS		0	// USB Cmd 0x52.  Pin change interrupt on the CW key inputs.  Debounced CW key
+								// and PTT edges are timestamped and queued, to be read with Cmd 0x52
+								// rather than polling Cmd 0x51 (Uses 56 bytes of RAM)
+
+#define CW_KEYER		0	// USB Cmd 0x53.  Iambic A/B keyer, timed by a 1ms Timer1 compare interrupt.
+								// Paddles on the CW key inputs, PTT through the Mobo PCF or IO_PTT.
+								// Key down is reported in Cmd 0x51 bit 7 (and Cmd 0x52 edges)
+
+#define TR_SEQUENCER		0	// USB Cmd 0x54 and 0x55.  T/R sequencer, PTT from Cmd 0x50 (and the keyer)
+								// switches RX mute, antenna relay, PTT, bias and PTT2 in order, with a
+								// configurable delay before each step, and the reverse for RX
+
+#define FAST_METERING		0	// Power, voltage and current readings by multiply and shift, with constants
+								// worked out when the calibration values are changed, rather than
+								// by divisions on every reading
+
+#define SWR_FAST_TRIP		0	// USB Cmd 0x56.  Fast SWR trip, used with SWR_ALARM_FUNC.  During TX, the
+								// AD7991 is polled every 2.5ms, and PTT2 and the bias fallback are set
+								// after a configurable number of samples over the SWR threshold
+
+#define PEP_METER		0	// USB Cmd 0x57.  PEP, average and peak hold power metering, used with POWER_SWR.
+								// Updated on every 10ms AD7991 reading, at a constant cost per sample, and
+								// also used by the LCD PEP indication (PWR_PEAK_ENVELOPE)
+
+#define BIAS_FAST_CAL		0	// USB Cmd 0x58.  PA bias calibration by successive approximation, both bias
+								// settings are found in ~16 steps, with a settle time before each reading,
+								// rather than by stepping the bias DAC up one count every 10ms
+
+#define ADC_DECIMATE		0	// USB Cmd 0x59.  Accumulate and dump (boxcar) filter of the AD7991 readings,
+								// 1 - 16 readings per channel are summed into each value of ad7991_adc[],
+								// which then carries up to 16 bits instead of 12
+
+#define PWR_CAL_TABLE		0	// USB Cmds 0x4f, 0x5a and 0x5b.  Power meter calibration table, used with
+								// POWER_SWR.  Up to 16 (AD reading, mW) points for each of 4 bands, loaded
+								// by the host and interpolated, with a 32 bit power reading
+								// (Uses 96 bytes of RAM for the band table in use)
+
+#define LCD_FRAMEBUFFER		0	// Parallel LCD frame buffer.  The display routines write into a RAM image of the
+								// display, and only the characters which have changed are sent to the LCD,
+								// once per pass of maintask().  Costs ~100 bytes of RAM with a 20x4 display
+
+#define LCD_BACKGROUND		0	// Used with LCD_FRAMEBUFFER.  The frame buffer is sent to the LCD one character
+								// or command per pass of maintask(), when the LCD is not busy, rather than by
+								// waiting on the LCD busy flag.  Changes are sent within LCD_FLUSH_DEADLINE
+
+#define LCD_I2C_BATCH		0	// Used with LCD_I2C_DISPLAY.  Characters and cursor commands for the I2C LCD are
+								// collected, and sent as one I2C transaction at the end of each pass of
+								// maintask(), rather than one transaction for each character
+
+#define BARGRAPH_FAST		0	// LCD bargraphs drawn by changes.  The pixel scale is worked out when the
+								// full scale is changed, rather than by a 32 bit division on each reading,
+								// and only the bargraph characters which have changed are written
 
 //-----------------------------------------------------------------------------
 // Debug stuff, do not use
@@ -1097,6 +1397,10 @@
 #define ENCODER_INT_STYLE	0	// Interrupt driven Rotary Encoder VFO, uses one interrupt, gives
 								// only half the resolution of the encoder (every other click inactive)
 								//(Cost 652 bytes)
+#define ENCODER_INT_TABLE	0	// Used with ENCODER_INT_STYLE.  Interrupt on both phases (INT6 on Phase A,
+								// pin change interrupt PCINT12 on Phase B) with a table driven decoder.
+								// Gives full resolution of the encoder. Invalid transitions are counted
+								// and can be read through USB Cmd 0x69
 
 // It makes little sense to have both of the two below enabled at the same time.
 #define ENCODER_CMD_INCR	0	// USB Cmd 0x36. Modify Encoder Resolution, 32 bit signed integer.
@@ -1109,6 +1413,102 @@
 #define ENCODER_DIR_SENSE	1	// Direction change sense.  Used with variable speed feature.
 								// Direction change drops immediately out of fast speed mode
 								// (cost 42 bytes)
+#define ENCODER_ACCEL	0	// Used with ENCODER_INT_STYLE.  Velocity based acceleration curve, the step
+								// size follows the encoder speed, measured between encoder pulses.
+								// Replaces ENCODER_FAST_ENABLE.  Curve is read/modified with USB Cmd 0x6a
+#define ENCODER_FAST_RETUNE	0	// Used with ENCODER_INT_STYLE.  Write encoder frequency changes to the Si570
+								// on the next mainloop pass rather than in the 10ms slot, at most once
+								// per ENC_RETUNE_MIN.  Retune latency can be read through USB Cmd 0x69
+
+//-----------------------------------------------------------------------------
+// USB command handling
+//
+#define USB_DEFERRED_CMD	0	// Defer EEPROM writes and I2C traffic caused by USB commands to the
+								// mainloop.  The USB control request is answered immediately, using
+								// cached values where possible (Cmd 0x3f returns the Si570 registers
+								// last written, rather than reading them back from the chip)
+								// (Uses 32 bytes of RAM for the command queue)
+
+#define USB_TELEMETRY	0	// Interrupt IN endpoint (EP1) streaming a telemetry record with the ADC
+								// inputs, temperature, SWR, status flags and frequency.  Interval set
+								// with USB Cmd 0x63, default 100ms during RX and 10ms during TX
+
+#define USB_SNAPSHOT_CMD	0	// USB Cmd 0x62.  Read a consistent snapshot of all ADC inputs, temperature,
+								// SWR, power, selected filters and status flags in a single transfer.
+								// Double buffered, updated every 10ms (Uses 52 bytes of RAM)
+
+#define USB_CONFIG_IMAGE	0	// USB Cmd 0x37, 0x44 and 0x45.  Dump and restore the whole EEPROM settings
+								// image in chunks, with a CRC check before a restored image is used
+
+#define USB_BATCH_CMD		0	// USB Cmd 0x38 and 0x46.  Execute a batch of sub-commands (e.g. set frequency,
+								// set PTT and read the CW key state) in a single OUT transfer of up to
+								// 24 bytes, the concatenated results are read back with Cmd 0x46
+								// (Uses 33 bytes of RAM)
+
+#define USB_TIMED_FREQ		0	// USB Cmd 0x48 and 0x49.  Write a new frequency to the Si570 when the USB
+								// frame number reaches a given value, and report the frame number
+								// in which it was written, for retunes aligned with the audio stream
+
+#define USB_HOP_LIST		0	// USB Cmd 0x4a and 0x4b.  Step through a list of up to HOP_LIST_LEN frequencies,
+								// each with its own dwell time in ms, timed by the firmware rather
+								// than by the host (Uses 60 bytes of RAM)
+
+#define SWR_SWEEP		0	// USB Cmd 0x4c, 0x4d and 0x4e.  SWR sweep, the firmware steps through a range
+								// of frequencies with the transmitter keyed, measuring SWR at each
+								// point.  Used with POWER_SWR (Uses 120 bytes of RAM)
+
+#define CW_KEY_EVENTS		0	// USB Cmd 0x52.  Pin change interrupt on the CW key inputs.  Debounced CW key
+								// and PTT edges are timestamped and queued, to be read with Cmd 0x52
+								// rather than polling Cmd 0x51 (Uses 56 bytes of RAM)
+
+#define CW_KEYER		0	// USB Cmd 0x53.  Iambic A/B keyer, timed by a 1ms Timer1 compare interrupt.
+								// Paddles on the CW key inputs, PTT through the Mobo PCF or IO_PTT.
+								// Key down is reported in Cmd 0x51 bit 7 (and Cmd 0x52 edges)
+
+#define TR_SEQUENCER		0	// USB Cmd 0x54 and 0x55.  T/R sequencer, PTT from Cmd 0x50 (and the keyer)
+								// switches RX mute, antenna relay, PTT, bias and PTT2 in order, with a
+								// configurable delay before each step, and the reverse for RX
+
+#define FAST_METERING		0	// Power, voltage and current readings by multiply and shift, with constants
+								// worked out when the calibration values are changed, rather than
+								// by divisions on every reading
+
+#define SWR_FAST_TRIP		0	// USB Cmd 0x56.  Fast SWR trip, used with SWR_ALARM_FUNC.  During TX, the
+								// AD7991 is polled every 2.5ms, and PTT2 and the bias fallback are set
+								// after a configurable number of samples over the SWR threshold
+
+#define PEP_METER		0	// USB Cmd 0x57.  PEP, average and peak hold power metering, used with POWER_SWR.
+								// Updated on every 10ms AD7991 reading, at a constant cost per sample, and
+								// also used by the LCD PEP indication (PWR_PEAK_ENVELOPE)
+
+#define BIAS_FAST_CAL		0	// USB Cmd 0x58.  PA bias calibration by successive approximation, both bias
+								// settings are found in ~16 steps, with a settle time before each reading,
+								// rather than by stepping the bias DAC up one count every 10ms
+
+#define ADC_DECIMATE		0	// USB Cmd 0x59.  Accumulate and dump (boxcar) filter of the AD7991 readings,
+								// 1 - 16 readings per channel are summed into each value of ad7991_adc[],
+								// which then carries up to 16 bits instead of 12
+
+#define PWR_CAL_TABLE		0	// USB Cmds 0x4f, 0x5a and 0x5b.  Power meter calibration table, used with
+								// POWER_SWR.  Up to 16 (AD reading, mW) points for each of 4 bands, loaded
+								// by the host and interpolated, with a 32 bit power reading
+								// (Uses 96 bytes of RAM for the band table in use)
+
+#define LCD_FRAMEBUFFER		0	// Parallel LCD frame buffer.  The display routines write into a RAM image of the
+								// display, and only the characters which have changed are sent to the LCD,
+								// once per pass of maintask().  Costs ~100 bytes of RAM with a 20x4 display
+
+#define LCD_BACKGROUND		0	// Used with LCD_FRAMEBUFFER.  The frame buffer is sent to the LCD one character
+								// or command per pass of maintask(), when the LCD is not busy, rather than by
+								// waiting on the LCD busy flag.  Changes are sent within LCD_FLUSH_DEADLINE
+
+#define LCD_I2C_BATCH		0	// Used with LCD_I2C_DISPLAY.  Characters and cursor commands for the I2C LCD are
+								// collected, and sent as one I2C transaction at the end of each pass of
+								// maintask(), rather than one transaction for each character
+
+#define BARGRAPH_FAST		0	// LCD bargraphs drawn by changes.  The pixel scale is worked out when the
+								// full scale is changed, rather than by a 32 bit division on each reading,
+								// and only the bargraph characters which have changed are written
 
 //-----------------------------------------------------------------------------
 // Debug stuff, do not use
@@ -1352,6 +1752,10 @@
 #define ENCODER_INT_STYLE	0	// Interrupt driven Rotary Encoder VFO, uses one interrupt, gives
 								// only half the resolution of the encoder (every other click inactive)
 								//(Cost 652 bytes)
+#define ENCODER_INT_TABLE	0	// Used with ENCODER_INT_STYLE.  Interrupt on both phases (INT6 on Phase A,
+								// pin change interrupt PCINT12 on Phase B) with a table driven decoder.
+								// Gives full resolution of the encoder. Invalid transitions are counted
+								// and can be read through USB Cmd 0x69
 
 // It makes little sense to have both of the two below enabled at the same time.
 #define ENCODER_CMD_INCR	0	// USB Cmd 0x36. Modify Encoder Resolution, 32 bit signed integer.
@@ -1364,6 +1768,102 @@
 #define ENCODER_DIR_SENSE	1	// Direction change sense.  Used with variable speed feature.
 								// Direction change drops immediately out of fast speed mode
 								// (cost 42 bytes)
+#define ENCODER_ACCEL	0	// Used with ENCODER_INT_STYLE.  Velocity based acceleration curve, the step
+								// size follows the encoder speed, measured between encoder pulses.
+								// Replaces ENCODER_FAST_ENABLE.  Curve is read/modified with USB Cmd 0x6a
+#define ENCODER_FAST_RETUNE	0	// Used with ENCODER_INT_STYLE.  Write encoder frequency changes to the Si570
+								// on the next mainloop pass rather than in the 10ms slot, at most once
+								// per ENC_RETUNE_MIN.  Retune latency can be read through USB Cmd 0x69
+
+//-----------------------------------------------------------------------------
+// USB command handling
+//
+#define USB_DEFERRED_CMD	0	// Defer EEPROM writes and I2C traffic caused by USB commands to the
+								// mainloop.  The USB control request is answered immediately, using
+								// cached values where possible (Cmd 0x3f returns the Si570 registers
+								// last written, rather than reading them back from the chip)
+								// (Uses 32 bytes of RAM for the command queue)
+
+#define USB_TELEMETRY	0	// Interrupt IN endpoint (EP1) streaming a telemetry record with the ADC
+								// inputs, temperature, SWR, status flags and frequency.  Interval set
+								// with USB Cmd 0x63, default 100ms during RX and 10ms during TX
+
+#define USB_SNAPSHOT_CMD	0	// USB Cmd 0x62.  Read a consistent snapshot of all ADC inputs, temperature,
+								// SWR, power, selected filters and status flags in a single transfer.
+								// Double buffered, updated every 10ms (Uses 52 bytes of RAM)
+
+#define USB_CONFIG_IMAGE	0	// USB Cmd 0x37, 0x44 and 0x45.  Dump and restore the whole EEPROM settings
+								// image in chunks, with a CRC check before a restored image is used
+
+#define USB_BATCH_CMD		0	// USB Cmd 0x38 and 0x46.  Execute a batch of sub-commands (e.g. set frequency,
+								// set PTT and read the CW key state) in a single OUT transfer of up to
+								// 24 bytes, the concatenated results are read back with Cmd 0x46
+								// (Uses 33 bytes of RAM)
+
+#define USB_TIMED_FREQ		0	// USB Cmd 0x48 and 0x49.  Write a new frequency to the Si570 when the USB
+								// frame number reaches a given value, and report the frame number
+								// in which it was written, for retunes aligned with the audio stream
+
+#define USB_HOP_LIST		0	// USB Cmd 0x4a and 0x4b.  Step through a list of up to HOP_LIST_LEN frequencies,
+								// each with its own dwell time in ms, timed by the firmware rather
+								// than by the host (Uses 60 bytes of RAM)
+
+#define SWR_SWEEP		0	// USB Cmd 0x4c, 0x4d and 0x4e.  SWR sweep, the firmware steps through a range
+								// of frequencies with the transmitter keyed, measuring SWR at each
+								// point.  Used with POWER_SWR (Uses 120 bytes of RAM)
+
+#define CW_KEY_EVENTS		0	// USB Cmd 0x52.  Pin change interrupt on the CW key inputs.  Debounced CW key
+								// and PTT edges are timestamped and queued, to be read with Cmd 0x52
+								// rather than polling Cmd 0x51 (Uses 56 bytes of RAM)
+
+#define CW_KEYER		0	// USB Cmd 0x53.  Iambic A/B keyer, timed by a 1ms Timer1 compare interrupt.
+								// Paddles on the CW key inputs, PTT through the Mobo PCF or IO_PTT.
+								// Key down is reported in Cmd 0x51 bit 7 (and Cmd 0x52 edges)
+
+#define TR_SEQUENCER		0	// USB Cmd 0x54 and 0x55.  T/R sequencer, PTT from Cmd 0x50 (and the keyer)
+								// switches RX mute, antenna relay, PTT, bias and PTT2 in order, with a
+								// configurable delay before each step, and the reverse for RX
+
+#define FAST_METERING		0	// Power, voltage and current readings by multiply and shift, with constants
+								// worked out when the calibration values are changed, rather than
+								// by divisions on every reading
+
+#define SWR_FAST_TRIP		0	// USB Cmd 0x56.  Fast SWR trip, used with SWR_ALARM_FUNC.  During TX, the
+								// AD7991 is polled every 2.5ms, and PTT2 and the bias fallback are set
+								// after a configurable number of samples over the SWR threshold
+
+#define PEP_METER		0	// USB Cmd 0x57.  PEP, average and peak hold power metering, used with POWER_SWR.
+								// Updated on every 10ms AD7991 reading, at a constant cost per sample, and
+								// also used by the LCD PEP indication (PWR_PEAK_ENVELOPE)
+
+#define BIAS_FAST_CAL		0	// USB Cmd 0x58.  PA bias calibration by successive approximation, both bias
+								// settings are found in ~16 steps, with a settle time before each reading,
+								// rather than by stepping the bias DAC up one count every 10ms
+
+#define ADC_DECIMATE		0	// USB Cmd 0x59.  Accumulate and dump (boxcar) filter of the AD7991 readings,
+								// 1 - 16 readings per channel are summed into each value of ad7991_adc[],
+								// which then carries up to 16 bits instead of 12
+
+#define PWR_CAL_TABLE		0	// USB Cmds 0x4f, 0x5a and 0x5b.  Power meter calibration table, used with
+								// POWER_SWR.  Up to 16 (AD reading, mW) points for each of 4 bands, loaded
+								// by the host and interpolated, with a 32 bit power reading
+								// (Uses 96 bytes of RAM for the band table in use)
+
+#define LCD_FRAMEBUFFER		0	// Parallel LCD frame buffer.  The display routines write into a RAM image of the
+								// display, and only the characters which have changed are sent to the LCD,
+								// once per pass of maintask().  Costs ~100 bytes of RAM with a 20x4 display
+
+#define LCD_BACKGROUND		0	// Used with LCD_FRAMEBUFFER.  The frame buffer is sent to the LCD one character
+								// or command per pass of maintask(), when the LCD is not busy, rather than by
+								// waiting on the LCD busy flag.  Changes are sent within LCD_FLUSH_DEADLINE
+
+#define LCD_I2C_BATCH		0	// Used with LCD_I2C_DISPLAY.  Characters and cursor commands for the I2C LCD are
+								// collected, and sent as one I2C transaction at the end of each pass of
+								// maintask(), rather than one transaction for each character
+
+#define BARGRAPH_FAST		0	// LCD bargraphs drawn by changes.  The pixel scale is worked out when the
+								// full scale is changed, rather than by a 32 bit division on each reading,
+								// and only the bargraph characters which have changed are written
 
 //-----------------------------------------------------------------------------
 // Debug stuff, do not use
@@ -1607,6 +2107,10 @@
 #define ENCODER_INT_STYLE	0	// Interrupt driven Rotary Encoder VFO, uses one interrupt, gives
 								// only half the resolution of the encoder (every other click inactive)
 								//(Cost 652 bytes)
+#define ENCODER_INT_TABLE	0	// Used with ENCODER_INT_STYLE.  Interrupt on both phases (INT6 on Phase A,
+								// pin change interrupt PCINT12 on Phase B) with a table driven decoder.
+								// Gives full resolution of the encoder. Invalid transitions are counted
+								// and can be read through USB Cmd 0x69
 
 // It makes little sense to have both of the two below enabled at the same time.
 #define ENCODER_CMD_INCR	0	// USB Cmd 0x36. Modify Encoder Resolution, 32 bit signed integer.
@@ -1619,6 +2123,102 @@
 #define ENCODER_DIR_SENSE	1	// Direction change sense.  Used with variable speed feature.
 								// Direction change drops immediately out of fast speed mode
 								// (cost 42 bytes)
+#define ENCODER_ACCEL	0	// Used with ENCODER_INT_STYLE.  Velocity based acceleration curve, the step
+								// size follows the encoder speed, measured between encoder pulses.
+								// Replaces ENCODER_FAST_ENABLE.  Curve is read/modified with USB Cmd 0x6a
+#define ENCODER_FAST_RETUNE	0	// Used with ENCODER_INT_STYLE.  Write encoder frequency changes to the Si570
+								// on the next mainloop pass rather than in the 10ms slot, at most once
+								// per ENC_RETUNE_MIN.  Retune latency can be read through USB Cmd 0x69
+
+//-----------------------------------------------------------------------------
+// USB command handling
+//
+#define USB_DEFERRED_CMD	0	// Defer EEPROM writes and I2C traffic caused by USB commands to the
+								// mainloop.  The USB control request is answered immediately, using
+								// cached values where possible (Cmd 0x3f returns the Si570 registers
+								// last written, rather than reading them back from the chip)
+								// (Uses 32 bytes of RAM for the command queue)
+
+#define USB_TELEMETRY	0	// Interrupt IN endpoint (EP1) streaming a telemetry record with the ADC
+								// inputs, temperature, SWR, status flags and frequency.  Interval set
+								// with USB Cmd 0x63, default 100ms during RX and 10ms during TX
+
+#define USB_SNAPSHOT_CMD	0	// USB Cmd 0x62.  Read a consistent snapshot of all ADC inputs, temperature,
+								// SWR, power, selected filters and status flags in a single transfer.
+								// Double buffered, updated every 10ms (Uses 52 bytes of RAM)
+
+#define USB_CONFIG_IMAGE	0	// USB Cmd 0x37, 0x44 and 0x45.  Dump and restore the whole EEPROM settings
+								// image in chunks, with a CRC check before a restored image is used
+
+#define USB_BATCH_CMD		0	// USB Cmd 0x38 and 0x46.  Execute a batch of sub-commands (e.g. set frequency,
+								// set PTT and read the CW key state) in a single OUT transfer of up to
+								// 24 bytes, the concatenated results are read back with Cmd 0x46
+								// (Uses 33 bytes of RAM)
+
+#define USB_TIMED_FREQ		0	// USB Cmd 0x48 and 0x49.  Write a new frequency to the Si570 when the USB
+								// frame number reaches a given value, and report the frame number
+								// in which it was written, for retunes aligned with the audio stream
+
+#define USB_HOP_LIST		0	// USB Cmd 0x4a and 0x4b.  Step through a list of up to HOP_LIST_LEN frequencies,
+								// each with its own dwell time in ms, timed by the firmware rather
+								// than by the host (Uses 60 bytes of RAM)
+
+#define SWR_SWEEP		0	// USB Cmd 0x4c, 0x4d and 0x4e.  SWR sweep, the firmware steps through a range
+								// of frequencies with the transmitter keyed, measuring SWR at each
+								// point.  Used with POWER_SWR (Uses 120 bytes of RAM)
+
+#define CW_KEY_EVENTS		0	// USB Cmd 0x52.  Pin change interrupt on the CW key inputs.  Debounced CW key
+								// and PTT edges are timestamped and queued, to be read with Cmd 0x52
+								// rather than polling Cmd 0x51 (Uses 56 bytes of RAM)
+
+#define CW_KEYER		0	// USB Cmd 0x53.  Iambic A/B keyer, timed by a 1ms Timer1 compare interrupt.
+								// Paddles on the CW key inputs, PTT through the Mobo PCF or IO_PTT.
+								// Key down is reported in Cmd 0x51 bit 7 (and Cmd 0x52 edges)
+
+#define TR_SEQUENCER		0	// USB Cmd 0x54 and 0x55.  T/R sequencer, PTT from Cmd 0x50 (and the keyer)
+								// switches RX mute, antenna relay, PTT, bias and PTT2 in order, with a
+								// configurable delay before each step, and the reverse for RX
+
+#define FAST_METERING		0	// Power, voltage and current readings by multiply and shift, with constants
+								// worked out when the calibration values are changed, rather than
+								// by divisions on every reading
+
+#define SWR_FAST_TRIP		0	// USB Cmd 0x56.  Fast SWR trip, used with SWR_ALARM_FUNC.  During TX, the
+								// AD7991 is polled every 2.5ms, and PTT2 and the bias fallback are set
+								// after a configurable number of samples over the SWR threshold
+
+#define PEP_METER		0	// USB Cmd 0x57.  PEP, average and peak hold power metering, used with POWER_SWR.
+								// Updated on every 10ms AD7991 reading, at a constant cost per sample, and
+								// also used by the LCD PEP indication (PWR_PEAK_ENVELOPE)
+
+#define BIAS_FAST_CAL		0	// USB Cmd 0x58.  PA bias calibration by successive approximation, both bias
+								// settings are found in ~16 steps, with a settle time before each reading,
+								// rather than by stepping the bias DAC up one count every 10ms
+
+#define ADC_DECIMATE		0	// USB Cmd 0x59.  Accumulate and dump (boxcar) filter of the AD7991 readings,
+								// 1 - 16 readings per channel are summed into each value of ad7991_adc[],
+								// which then carries up to 16 bits instead of 12
+
+#define PWR_CAL_TABLE		0	// USB Cmds 0x4f, 0x5a and 0x5b.  Power meter calibration table, used with
+								// POWER_SWR.  Up to 16 (AD reading, mW) points for each of 4 bands, loaded
+								// by the host and interpolated, with a 32 bit power reading
+								// (Uses 96 bytes of RAM for the band table in use)
+
+#define LCD_FRAMEBUFFER		0	// Parallel LCD frame buffer.  The display routines write into a RAM image of the
+								// display, and only the characters which have changed are sent to the LCD,
+								// once per pass of maintask().  Costs ~100 bytes of RAM with a 20x4 display
+
+#define LCD_BACKGROUND		0	// Used with LCD_FRAMEBUFFER.  The frame buffer is sent to the LCD one character
+								// or command per pass of maintask(), when the LCD is not busy, rather than by
+								// waiting on the LCD busy flag.  Changes are sent within LCD_FLUSH_DEADLINE
+
+#define LCD_I2C_BATCH		0	// Used with LCD_I2C_DISPLAY.  Characters and cursor commands for the I2C LCD are
+								// collected, and sent as one I2C transaction at the end of each pass of
+								// maintask(), rather than one transaction for each character
+
+#define BARGRAPH_FAST		0	// LCD bargraphs drawn by changes.  The pixel scale is worked out when the
+								// full scale is changed, rather than by a 32 bit division on each reading,
+								// and only the bargraph characters which have changed are written
 
 //-----------------------------------------------------------------------------
 // Debug stuff, do not use
@@ -1862,6 +2462,10 @@
 #define ENCODER_INT_STYLE	0	// Interrupt driven Rotary Encoder VFO, uses one interrupt, gives
 								// only half the resolution of the encoder (every other click inactive)
 								//(Cost 652 bytes)
+#define ENCODER_INT_TABLE	0	// Used with ENCODER_INT_STYLE.  Interrupt on both phases (INT6 on Phase A,
+								// pin change interrupt PCINT12 on Phase B) with a table driven decoder.
+								// Gives full resolution of the encoder. Invalid transitions are counted
+								// and can be read through USB Cmd 0x69
 
 // It makes little sense to have both of the two below enabled at the same time.
 #define ENCODER_CMD_INCR	0	// USB Cmd 0x36. Modify Encoder Resolution, 32 bit signed integer.
@@ -1874,6 +2478,102 @@
 #define ENCODER_DIR_SENSE	0	// Direction change sense.  Used with variable speed feature.
 								// Direction change drops immediately out of fast speed mode
 								// (cost 42 bytes)
+#define ENCODER_ACCEL	0	// Used with ENCODER_INT_STYLE.  Velocity based acceleration curve, the step
+								// size follows the encoder speed, measured between encoder pulses.
+								// Replaces ENCODER_FAST_ENABLE.  Curve is read/modified with USB Cmd 0x6a
+#define ENCODER_FAST_RETUNE	0	// Used with ENCODER_INT_STYLE.  Write encoder frequency changes to the Si570
+								// on the next mainloop pass rather than in the 10ms slot, at most once
+								// per ENC_RETUNE_MIN.  Retune latency can be read through USB Cmd 0x69
+
+//-----------------------------------------------------------------------------
+// USB command handling
+//
+#define USB_DEFERRED_CMD	0	// Defer EEPROM writes and I2C traffic caused by USB commands to the
+								// mainloop.  The USB control request is answered immediately, using
+								// cached values where possible (Cmd 0x3f returns the Si570 registers
+								// last written, rather than reading them back from the chip)
+								// (Uses 32 bytes of RAM for the command queue)
+
+#define USB_TELEMETRY	0	// Interrupt IN endpoint (EP1) streaming a telemetry record with the ADC
+								// inputs, temperature, SWR, status flags and frequency.  Interval set
+								// with USB Cmd 0x63, default 100ms during RX and 10ms during TX
+
+#define USB_SNAPSHOT_CMD	0	// USB Cmd 0x62.  Read a consistent snapshot of all ADC inputs, temperature,
+								// SWR, power, selected filters and status flags in a single transfer.
+								// Double buffered, updated every 10ms (Uses 52 bytes of RAM)
+
+#define USB_CONFIG_IMAGE	0	// USB Cmd 0x37, 0x44 and 0x45.  Dump and restore the whole EEPROM settings
+								// image in chunks, with a CRC check before a restored image is used
+
+#define USB_BATCH_CMD		0	// USB Cmd 0x38 and 0x46.  Execute a batch of sub-commands (e.g. set frequency,
+								// set PTT and read the CW key state) in a single OUT transfer of up to
+								// 24 bytes, the concatenated results are read back with Cmd 0x46
+								// (Uses 33 bytes of RAM)
+
+#define USB_TIMED_FREQ		0	// USB Cmd 0x48 and 0x49.  Write a new frequency to the Si570 when the USB
+								// frame number reaches a given value, and report the frame number
+								// in which it was written, for retunes aligned with the audio stream
+
+#define USB_HOP_LIST		0	// USB Cmd 0x4a and 0x4b.  Step through a list of up to HOP_LIST_LEN frequencies,
+								// each with its own dwell time in ms, timed by the firmware rather
+								// than by the host (Uses 60 bytes of RAM)
+
+#define SWR_SWEEP		0	// USB Cmd 0x4c, 0x4d and 0x4e.  SWR sweep, the firmware steps through a range
+								// of frequencies with the transmitter keyed, measuring SWR at each
+								// point.  Used with POWER_SWR (Uses 120 bytes of RAM)
+
+#define CW_KEY_EVENTS		0	// USB Cmd 0x52.  Pin change interrupt on the CW key inputs.  Debounced CW key
+								// and PTT edges are timestamped and queued, to be read with Cmd 0x52
+								// rather than polling Cmd 0x51 (Uses 56 bytes of RAM)
+
+#define CW_KEYER		0	// USB Cmd 0x53.  Iambic A/B keyer, timed by a 1ms Timer1 compare interrupt.
+								// Paddles on the CW key inputs, PTT through the Mobo PCF or IO_PTT.
+								// Key down is reported in Cmd 0x51 bit 7 (and Cmd 0x52 edges)
+
+#define TR_SEQUENCER		0	// USB Cmd 0x54 and 0x55.  T/R sequencer, PTT from Cmd 0x50 (and the keyer)
+								// switches RX mute, antenna relay, PTT, bias and PTT2 in order, with a
+								// configurable delay before each step, and the reverse for RX
+
+#define FAST_METERING		0	// Power, voltage and current readings by multiply and shift, with constants
+								// worked out when the calibration values are changed, rather than
+								// by divisions on every reading
+
+#define SWR_FAST_TRIP		0	// USB Cmd 0x56.  Fast SWR trip, used with SWR_ALARM_FUNC.  During TX, the
+								// AD7991 is polled every 2.5ms, and PTT2 and the bias fallback are set
+								// after a configurable number of samples over the SWR threshold
+
+#define PEP_METER		0	// USB Cmd 0x57.  PEP, average and peak hold power metering, used with POWER_SWR.
+								// Updated on every 10ms AD7991 reading, at a constant cost per sample, and
+								// also used by the LCD PEP indication (PWR_PEAK_ENVELOPE)
+
+#define BIAS_FAST_CAL		0	// USB Cmd 0x58.  PA bias calibration by successive approximation, both bias
+								// settings are found in ~16 steps, with a settle time before each reading,
+								// rather than by stepping the bias DAC up one count every 10ms
+
+#define ADC_DECIMATE		0	// USB Cmd 0x59.  Accumulate and dump (boxcar) filter of the AD7991 readings,
+								// 1 - 16 readings per channel are summed into each value of ad7991_adc[],
+								// which then carries up to 16 bits instead of 12
+
+#define PWR_CAL_TABLE		0	// USB Cmds 0x4f, 0x5a and 0x5b.  Power meter calibration table, used with
+								// POWER_SWR.  Up to 16 (AD reading, mW) points for each of 4 bands, loaded
+								// by the host and interpolated, with a 32 bit power reading
+								// (Uses 96 bytes of RAM for the band table in use)
+
+#define LCD_FRAMEBUFFER		0	// Parallel LCD frame buffer.  The display routines write into a RAM image of the
+								// display, and only the characters which have changed are sent to the LCD,
+								// once per pass of maintask().  Costs ~100 bytes of RAM with a 20x4 display
+
+#define LCD_BACKGROUND		0	// Used with LCD_FRAMEBUFFER.  The frame buffer is sent to the LCD one character
+								// or command per pass of maintask(), when the LCD is not busy, rather than by
+								// waiting on the LCD busy flag.  Changes are sent within LCD_FLUSH_DEADLINE
+
+#define LCD_I2C_BATCH		0	// Used with LCD_I2C_DISPLAY.  Characters and cursor commands for the I2C LCD are
+								// collected, and sent as one I2C transaction at the end of each pass of
+								// maintask(), rather than one transaction for each character
+
+#define BARGRAPH_FAST		0	// LCD bargraphs drawn by changes.  The pixel scale is worked out when the
+								// full scale is changed, rather than by a 32 bit division on each reading,
+								// and only the bargraph characters which have changed are written
 
 //-----------------------------------------------------------------------------
 // Debug stuff, do not use
@@ -2117,6 +2817,10 @@
 #define ENCODER_INT_STYLE	0	// Interrupt driven Rotary Encoder VFO, uses one interrupt, gives
 								// only half the resolution of the encoder (every other click inactive)
 								//(Cost 652 bytes)
+#define ENCODER_INT_TABLE	0	// Used with ENCODER_INT_STYLE.  Interrupt on both phases (INT6 on Phase A,
+								// pin change interrupt PCINT12 on Phase B) with a table driven decoder.
+								// Gives full resolution of the encoder. Invalid transitions are counted
+								// and can be read through USB Cmd 0x69
 
 // It makes little sense to have both of the two below enabled at the same time.
 #define ENCODER_CMD_INCR	0	// USB Cmd 0x36. Modify Encoder Resolution, 32 bit signed integer.
@@ -2129,6 +2833,102 @@
 #define ENCODER_DIR_SENSE	0	// Direction change sense.  Used with variable speed feature.
 								// Direction change drops immediately out of fast speed mode
 								// (cost 42 bytes)
+#define ENCODER_ACCEL	0	// Used with ENCODER_INT_STYLE.  Velocity based acceleration curve, the step
+								// size follows the encoder speed, measured between encoder pulses.
+								// Replaces ENCODER_FAST_ENABLE.  Curve is read/modified with USB Cmd 0x6a
+#define ENCODER_FAST_RETUNE	0	// Used with ENCODER_INT_STYLE.  Write encoder frequency changes to the Si570
+								// on the next mainloop pass rather than in the 10ms slot, at most once
+								// per ENC_RETUNE_MIN.  Retune latency can be read through USB Cmd 0x69
+
+//-----------------------------------------------------------------------------
+// USB command handling
+//
+#define USB_DEFERRED_CMD	0	// Defer EEPROM writes and I2C traffic caused by USB commands to the
+								// mainloop.  The USB control request is answered immediately, using
+								// cached values where possible (Cmd 0x3f returns the Si570 registers
+								// last written, rather than reading them back from the chip)
+								// (Uses 32 bytes of RAM for the command queue)
+
+#define USB_TELEMETRY	0	// Interrupt IN endpoint (EP1) streaming a telemetry record with the ADC
+								// inputs, temperature, SWR, status flags and frequency.  Interval set
+								// with USB Cmd 0x63, default 100ms during RX and 10ms during TX
+
+#define USB_SNAPSHOT_CMD	0	// USB Cmd 0x62.  Read a consistent snapshot of all ADC inputs, temperature,
+								// SWR, power, selected filters and status flags in a single transfer.
+								// Double buffered, updated every 10ms (Uses 52 bytes of RAM)
+
+#define USB_CONFIG_IMAGE	0	// USB Cmd 0x37, 0x44 and 0x45.  Dump and restore the whole EEPROM settings
+								// image in chunks, with a CRC check before a restored image is used
+
+#define USB_BATCH_CMD		0	// USB Cmd 0x38 and 0x46.  Execute a batch of sub-commands (e.g. set frequency,
+								// set PTT and read the CW key state) in a single OUT transfer of up to
+								// 24 bytes, the concatenated results are read back with Cmd 0x46
+								// (Uses 33 bytes of RAM)
+
+#define USB_TIMED_FREQ		0	// USB Cmd 0x48 and 0x49.  Write a new frequency to the Si570 when the USB
+								// frame number reaches a given value, and report the frame number
+								// in which it was written, for retunes aligned with the audio stream
+
+#define USB_HOP_LIST		0	// USB Cmd 0x4a and 0x4b.  Step through a list of up to HOP_LIST_LEN frequencies,
+								// each with its own dwell time in ms, timed by the firmware rather
+								// than by the host (Uses 60 bytes of RAM)
+
+#define SWR_SWEEP		0	// USB Cmd 0x4c, 0x4d and 0x4e.  SWR sweep, the firmware steps through a range
+								// of frequencies with the transmitter keyed, measuring SWR at each
+								// point.  Used with POWER_SWR (Uses 120 bytes of RAM)
+
+#define CW_KEY_EVENTS		0	// USB Cmd 0x52.  Pin change interrupt on the CW key inputs.  Debounced CW key
+								// and PTT edges are timestamped and queued, to be read with Cmd 0x52
+								// rather than polling Cmd 0x51 (Uses 56 bytes of RAM)
+
+#define CW_KEYER		0	// USB Cmd 0x53.  Iambic A/B keyer, timed by a 1ms Timer1 compare interrupt.
+								// Paddles on the CW key inputs, PTT through the Mobo PCF or IO_PTT.
+								// Key down is reported in Cmd 0x51 bit 7 (and Cmd 0x52 edges)
+
+#define TR_SEQUENCER		0	// USB Cmd 0x54 and 0x55.  T/R sequencer, PTT from Cmd 0x50 (and the keyer)
+								// switches RX mute, antenna relay, PTT, bias and PTT2 in order, with a
+								// configurable delay before each step, and the reverse for RX
+
+#define FAST_METERING		0	// Power, voltage and current readings by multiply and shift, with constants
+								// worked out when the calibration values are changed, rather than
+								// by divisions on every reading
+
+#define SWR_FAST_TRIP		0	// USB Cmd 0x56.  Fast SWR trip, used with SWR_ALARM_FUNC.  During TX, the
+								// AD7991 is polled every 2.5ms, and PTT2 and the bias fallback are set
+								// after a configurable number of samples over the SWR threshold
+
+#define PEP_METER		0	// USB Cmd 0x57.  PEP, average and peak hold power metering, used with POWER_SWR.
+								// Updated on every 10ms AD7991 reading, at a constant cost per sample, and
+								// also used by the LCD PEP indication (PWR_PEAK_ENVELOPE)
+
+#define BIAS_FAST_CAL		0	// USB Cmd 0x58.  PA bias calibration by successive approximation, both bias
+								// settings are found in ~16 steps, with a settle time before each reading,
+								// rather than by stepping the bias DAC up one count every 10ms
+
+#define ADC_DECIMATE		0	// USB Cmd 0x59.  Accumulate and dump (boxcar) filter of the AD7991 readings,
+								// 1 - 16 readings per channel are summed into each value of ad7991_adc[],
+								// which then carries up to 16 bits instead of 12
+
+#define PWR_CAL_TABLE		0	// USB Cmds 0x4f, 0x5a and 0x5b.  Power meter calibration table, used with
+								// POWER_SWR.  Up to 16 (AD reading, mW) points for each of 4 bands, loaded
+								// by the host and interpolated, with a 32 bit power reading
+								// (Uses 96 bytes of RAM for the band table in use)
+
+#define LCD_FRAMEBUFFER		0	// Parallel LCD frame buffer.  The display routines write into a RAM image of the
+								// display, and only the characters which have changed are sent to the LCD,
+								// once per pass of maintask().  Costs ~100 bytes of RAM with a 20x4 display
+
+#define LCD_BACKGROUND		0	// Used with LCD_FRAMEBUFFER.  The frame buffer is sent to the LCD one character
+								// or command per pass of maintask(), when the LCD is not busy, rather than by
+								// waiting on the LCD busy flag.  Changes are sent within LCD_FLUSH_DEADLINE
+
+#define LCD_I2C_BATCH		0	// Used with LCD_I2C_DISPLAY.  Characters and cursor commands for the I2C LCD are
+								// collected, and sent as one I2C transaction at the end of each pass of
+								// maintask(), rather than one transaction for each character
+
+#define BARGRAPH_FAST		0	// LCD bargraphs drawn by changes.  The pixel scale is worked out when the
+								// full scale is changed, rather than by a 32 bit division on each reading,
+								// and only the bargraph characters which have changed are written
 
 //-----------------------------------------------------------------------------
 // Debug stuff, do not use
@@ -2372,6 +3172,10 @@
 #define ENCODER_INT_STYLE	0	// Interrupt driven Rotary Encoder VFO, uses one interrupt, gives
 								// only half the resolution of the encoder (every other click inactive)
 								//(Cost 652 bytes)
+#define ENCODER_INT_TABLE	0	// Used with ENCODER_INT_STYLE.  Interrupt on both phases (INT6 on Phase A,
+								// pin change interrupt PCINT12 on Phase B) with a table driven decoder.
+								// Gives full resolution of the encoder. Invalid transitions are counted
+								// and can be read through USB Cmd 0x69
 
 // It makes little sense to have both of the two below enabled at the same time.
 #define ENCODER_CMD_INCR	0	// USB Cmd 0x36. Modify Encoder Resolution, 32 bit signed integer.
@@ -2384,6 +3188,102 @@
 #define ENCODER_DIR_SENSE	1	// Direction change sense.  Used with variable speed feature.
 								// Direction change drops immediately out of fast speed mode
 								// (cost 42 bytes)
+#define ENCODER_ACCEL	0	// Used with ENCODER_INT_STYLE.  Velocity based acceleration curve, the step
+								// size follows the encoder speed, measured between encoder pulses.
+								// Replaces ENCODER_FAST_ENABLE.  Curve is read/modified with USB Cmd 0x6a
+#define ENCODER_FAST_RETUNE	0	// Used with ENCODER_INT_STYLE.  Write encoder frequency changes to the Si570
+								// on the next mainloop pass rather than in the 10ms slot, at most once
+								// per ENC_RETUNE_MIN.  Retune latency can be read through USB Cmd 0x69
+
+//-----------------------------------------------------------------------------
+// USB command handling
+//
+#define USB_DEFERRED_CMD	0	// Defer EEPROM writes and I2C traffic caused by USB commands to the
+								// mainloop.  The USB control request is answered immediately, using
+								// cached values where possible (Cmd 0x3f returns the Si570 registers
+								// last written, rather than reading them back from the chip)
+								// (Uses 32 bytes of RAM for the command queue)
+
+#define USB_TELEMETRY	0	// Interrupt IN endpoint (EP1) streaming a telemetry record with the ADC
+								// inputs, temperature, SWR, status flags and frequency.  Interval set
+								// with USB Cmd 0x63, default 100ms during RX and 10ms during TX
+
+#define USB_SNAPSHOT_CMD	0	// USB Cmd 0x62.  Read a consistent snapshot of all ADC inputs, temperature,
+								// SWR, power, selected filters and status flags in a single transfer.
+								// Double buffered, updated every 10ms (Uses 52 bytes of RAM)
+
+#define USB_CONFIG_IMAGE	0	// USB Cmd 0x37, 0x44 and 0x45.  Dump and restore the whole EEPROM settings
+								// image in chunks, with a CRC check before a restored image is used
+
+#define USB_BATCH_CMD		0	// USB Cmd 0x38 and 0x46.  Execute a batch of sub-commands (e.g. set frequency,
+								// set PTT and read the CW key state) in a single OUT transfer of up to
+								// 24 bytes, the concatenated results are read back with Cmd 0x46
+								// (Uses 33 bytes of RAM)
+
+#define USB_TIMED_FREQ		0	// USB Cmd 0x48 and 0x49.  Write a new frequency to the Si570 when the USB
+								// frame number reaches a given value, and report the frame number
+								// in which it was written, for retunes aligned with the audio stream
+
+#define USB_HOP_LIST		0	// USB Cmd 0x4a and 0x4b.  Step through a list of up to HOP_LIST_LEN frequencies,
+								// each with its own dwell time in ms, timed by the firmware rather
+								// than by the host (Uses 60 bytes of RAM)
+
+#define SWR_SWEEP		0	// USB Cmd 0x4c, 0x4d and 0x4e.  SWR sweep, the firmware steps through a range
+								// of frequencies with the transmitter keyed, measuring SWR at each
+								// point.  Used with POWER_SWR (Uses 120 bytes of RAM)
+
+#define CW_KEY_EVENTS		0	// USB Cmd 0x52.  Pin change interrupt on the CW key inputs.  Debounced CW key
+								// and PTT edges are timestamped and queued, to be read with Cmd 0x52
+								// rather than polling Cmd 0x51 (Uses 56 bytes of RAM)
+
+#define CW_KEYER		0	// USB Cmd 0x53.  Iambic A/B keyer, timed by a 1ms Timer1 compare interrupt.
+								// Paddles on the CW key inputs, PTT through the Mobo PCF or IO_PTT.
+								// Key down is reported in Cmd 0x51 bit 7 (and Cmd 0x52 edges)
+
+#define TR_SEQUENCER		0	// USB Cmd 0x54 and 0x55.  T/R sequencer, PTT from Cmd 0x50 (and the keyer)
+								// switches RX mute, antenna relay, PTT, bias and PTT2 in order, with a
+								// configurable delay before each step, and the reverse for RX
+
+#define FAST_METERING		0	// Power, voltage and current readings by multiply and shift, with constants
+								// worked out when the calibration values are changed, rather than
+								// by divisions on every reading
+
+#define SWR_FAST_TRIP		0	// USB Cmd 0x56.  Fast SWR trip, used with SWR_ALARM_FUNC.  During TX, the
+								// AD7991 is polled every 2.5ms, and PTT2 and the bias fallback are set
+								// after a configurable number of samples over the SWR threshold
+
+#define PEP_METER		0	// USB Cmd 0x57.  PEP, average and peak hold power metering, used with POWER_SWR.
+								// Updated on every 10ms AD7991 reading, at a constant cost per sample, and
+								// also used by the LCD PEP indication (PWR_PEAK_ENVELOPE)
+
+#define BIAS_FAST_CAL		0	// USB Cmd 0x58.  PA bias calibration by successive approximation, both bias
+								// settings are found in ~16 steps, with a settle time before each reading,
+								// rather than by stepping the bias DAC up one count every 10ms
+
+#define ADC_DECIMATE		0	// USB Cmd 0x59.  Accumulate and dump (boxcar) filter of the AD7991 readings,
+								// 1 - 16 readings per channel are summed into each value of ad7991_adc[],
+								// which then carries up to 16 bits instead of 12
+
+#define PWR_CAL_TABLE		0	// USB Cmds 0x4f, 0x5a and 0x5b.  Power meter calibration table, used with
+								// POWER_SWR.  Up to 16 (AD reading, mW) points for each of 4 bands, loaded
+								// by the host and interpolated, with a 32 bit power reading
+								// (Uses 96 bytes of RAM for the band table in use)
+
+#define LCD_FRAMEBUFFER		0	// Parallel LCD frame buffer.  The display routines write into a RAM image of the
+								// display, and only the characters which have changed are sent to the LCD,
+								// once per pass of maintask().  Costs ~100 bytes of RAM with a 20x4 display
+
+#define LCD_BACKGROUND		0	// Used with LCD_FRAMEBUFFER.  The frame buffer is sent to the LCD one character
+								// or command per pass of maintask(), when the LCD is not busy, rather than by
+								// waiting on the LCD busy flag.  Changes are sent within LCD_FLUSH_DEADLINE
+
+#define LCD_I2C_BATCH		0	// Used with LCD_I2C_DISPLAY.  Characters and cursor commands for the I2C LCD are
+								// collected, and sent as one I2C transaction at the end of each pass of
+								// maintask(), rather than one transaction for each character
+
+#define BARGRAPH_FAST		0	// LCD bargraphs drawn by changes.  The pixel scale is worked out when the
+								// full scale is changed, rather than by a 32 bit division on each reading,
+								// and only the bargraph characters which have changed are written
 
 //-----------------------------------------------------------------------------
 // Debug stuff, do not use
@@ -2627,6 +3527,10 @@
 #define ENCODER_INT_STYLE	0	// Interrupt driven Rotary Encoder VFO, uses one interrupt, gives
 								// only half the resolution of the encoder (every other click inactive)
 								//(Cost 652 bytes)
+#define ENCODER_INT_TABLE	0	// Used with ENCODER_INT_STYLE.  Interrupt on both phases (INT6 on Phase A,
+								// pin change interrupt PCINT12 on Phase B) with a table driven decoder.
+								// Gives full resolution of the encoder. Invalid transitions are counted
+								// and can be read through USB Cmd 0x69
 
 // It makes little sense to have both of the two below enabled at the same time.
 #define ENCODER_CMD_INCR	0	// USB Cmd 0x36. Modify Encoder Resolution, 32 bit signed integer.
@@ -2639,6 +3543,102 @@
 #define ENCODER_DIR_SENSE	1	// Direction change sense.  Used with variable speed feature.
 								// Direction change drops immediately out of fast speed mode
 								// (cost 42 bytes)
+#define ENCODER_ACCEL	0	// Used with ENCODER_INT_STYLE.  Velocity based acceleration curve, the step
+								// size follows the encoder speed, measured between encoder pulses.
+								// Replaces ENCODER_FAST_ENABLE.  Curve is read/modified with USB Cmd 0x6a
+#define ENCODER_FAST_RETUNE	0	// Used with ENCODER_INT_STYLE.  Write encoder frequency changes to the Si570
+								// on the next mainloop pass rather than in the 10ms slot, at most once
+								// per ENC_RETUNE_MIN.  Retune latency can be read through USB Cmd 0x69
+
+//-----------------------------------------------------------------------------
+// USB command handling
+//
+#define USB_DEFERRED_CMD	0	// Defer EEPROM writes and I2C traffic caused by USB commands to the
+								// mainloop.  The USB control request is answered immediately, using
+								// cached values where possible (Cmd 0x3f returns the Si570 registers
+								// last written, rather than reading them back from the chip)
+								// (Uses 32 bytes of RAM for the command queue)
+
+#define USB_TELEMETRY	0	// Interrupt IN endpoint (EP1) streaming a telemetry record with the ADC
+								// inputs, temperature, SWR, status flags and frequency.  Interval set
+								// with USB Cmd 0x63, default 100ms during RX and 10ms during TX
+
+#define USB_SNAPSHOT_CMD	0	// USB Cmd 0x62.  Read a consistent snapshot of all ADC inputs, temperature,
+								// SWR, power, selected filters and status flags in a single transfer.
+								// Double buffered, updated every 10ms (Uses 52 bytes of RAM)
+
+#define USB_CONFIG_IMAGE	0	// USB Cmd 0x37, 0x44 and 0x45.  Dump and restore the whole EEPROM settings
+								// image in chunks, with a CRC check before a restored image is used
+
+#define USB_BATCH_CMD		0	// USB Cmd 0x38 and 0x46.  Execute a batch of sub-commands (e.g. set frequency,
+								// set PTT and read the CW key state) in a single OUT transfer of up to
+								// 24 bytes, the concatenated results are read back with Cmd 0x46
+								// (Uses 33 bytes of RAM)
+
+#define USB_TIMED_FREQ		0	// USB Cmd 0x48 and 0x49.  Write a new frequency to the Si570 when the USB
+								// frame number reaches a given value, and report the frame number
+								// in which it was written, for retunes aligned with the audio stream
+
+#define USB_HOP_LIST		0	// USB Cmd 0x4a and 0x4b.  Step through a list of up to HOP_LIST_LEN frequencies,
+								// each with its own dwell time in ms, timed by the firmware rather
+								// than by the host (Uses 60 bytes of RAM)
+
+#define SWR_SWEEP		0	// USB Cmd 0x4c, 0x4d and 0x4e.  SWR sweep, the firmware steps through a range
+								// of frequencies with the transmitter keyed, measuring SWR at each
+								// point.  Used with POWER_SWR (Uses 120 bytes of RAM)
+
+#define CW_KEY_EVENTS		0	// USB Cmd 0x52.  Pin change interrupt on the CW key inputs.  Debounced CW key
+								// and PTT edges are timestamped and queued, to be read with Cmd 0x52
+								// rather than polling Cmd 0x51 (Uses 56 bytes of RAM)
+
+#define CW_KEYER		0	// USB Cmd 0x53.  Iambic A/B keyer, timed by a 1ms Timer1 compare interrupt.
+								// Paddles on the CW key inputs, PTT through the Mobo PCF or IO_PTT.
+								// Key down is reported in Cmd 0x51 bit 7 (and Cmd 0x52 edges)
+
+#define TR_SEQUENCER		0	// USB Cmd 0x54 and 0x55.  T/R sequencer, PTT from Cmd 0x50 (and the keyer)
+								// switches RX mute, antenna relay, PTT, bias and PTT2 in order, with a
+								// configurable delay before each step, and the reverse for RX
+
+#define FAST_METERING		0	// Power, voltage and current readings by multiply and shift, with constants
+								// worked out when the calibration values are changed, rather than
+								// by divisions on every reading
+
+#define SWR_FAST_TRIP		0	// USB Cmd 0x56.  Fast SWR trip, used with SWR_ALARM_FUNC.  During TX, the
+								// AD7991 is polled every 2.5ms, and PTT2 and the bias fallback are set
+								// after a configurable number of samples over the SWR threshold
+
+#define PEP_METER		0	// USB Cmd 0x57.  PEP, average and peak hold power metering, used with POWER_SWR.
+								// Updated on every 10ms AD7991 reading, at a constant cost per sample, and
+								// also used by the LCD PEP indication (PWR_PEAK_ENVELOPE)
+
+#define BIAS_FAST_CAL		0	// USB Cmd 0x58.  PA bias calibration by successive approximation, both bias
+								// settings are found in ~16 steps, with a settle time before each reading,
+								// rather than by stepping the bias DAC up one count every 10ms
+
+#define ADC_DECIMATE		0	// USB Cmd 0x59.  Accumulate and dump (boxcar) filter of the AD7991 readings,
+								// 1 - 16 readings per channel are summed into each value of ad7991_adc[],
+								// which then carries up to 16 bits instead of 12
+
+#define PWR_CAL_TABLE		0	// USB Cmds 0x4f, 0x5a and 0x5b.  Power meter calibration table, used with
+								// POWER_SWR.  Up to 16 (AD reading, mW) points for each of 4 bands, loaded
+								// by the host and interpolated, with a 32 bit power reading
+								// (Uses 96 bytes of RAM for the band table in use)
+
+#define LCD_FRAMEBUFFER		0	// Parallel LCD frame buffer.  The display routines write into a RAM image of the
+								// display, and only the characters which have changed are sent to the LCD,
+								// once per pass of maintask().  Costs ~100 bytes of RAM with a 20x4 display
+
+#define LCD_BACKGROUND		0	// Used with LCD_FRAMEBUFFER.  The frame buffer is sent to the LCD one character
+								// or command per pass of maintask(), when the LCD is not busy, rather than by
+								// waiting on the LCD busy flag.  Changes are sent within LCD_FLUSH_DEADLINE
+
+#define LCD_I2C_BATCH		0	// Used with LCD_I2C_DISPLAY.  Characters and cursor commands for the I2C LCD are
+								// collected, and sent as one I2C transaction at the end of each pass of
+								// maintask(), rather than one transaction for each character
+
+#define BARGRAPH_FAST		0	// LCD bargraphs drawn by changes.  The pixel scale is worked out when the
+								// full scale is changed, rather than by a 32 bit division on each reading,
+								// and only the bargraph characters which have changed are written
 
 //-----------------------------------------------------------------------------
 // Debug stuff, do not use
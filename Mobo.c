@@ -419,6 +419,27 @@ EEMEM		var_t	E;							// Variables in eeprom (user modifiable, stored)
 					#if	ENCODER_RESOLUTION		// USB command to modify the Ecoder Resolution
 					,	ENC_PULSES				// Number of Resolvable States per Revolution
 					#endif
+					#if ENCODER_ACCEL			// Velocity based acceleration curve
+					,	ENC_ACCEL_CURVE			// Encoder click multiplier vs. time between pulses
+					#endif
+					#if CW_KEYER				// Iambic keyer
+					,	KEYER_DEFAULTS			// Mode, WPM, weight and PTT hang time
+					#endif
+					#if TR_SEQUENCER			// T/R sequencer
+					,	TR_DEFAULTS				// TX and RX step delays, mute and antenna relay bits
+					#endif
+					#if SWR_FAST_TRIP			// Fast SWR trip
+					,	SWR_TRIP_COUNT			// Samples in a row over the SWR threshold to trip
+					#endif
+					#if BIAS_FAST_CAL			// Fast PA bias calibration
+					,	BIAS_SETTLE				// Settle time before each bias reading, in 10ms
+					#endif
+					#if ADC_DECIMATE			// AD7991 decimation filter
+					,	ADC_DECIMATE_DEFAULTS	// 2^n readings per value, for each AD7991 channel
+					#endif
+					#if PWR_CAL_TABLE			// Power calibration table
+					,	PWR_CAL_DEFAULTS		// Number of points in each band table
+					#endif
 					#if PSDR_IQ_OFFSET36		// Display a fixed frequency offset during RX only.
 					//,	0.009000 * 4.0 * _2(21)	// Freq offset value is 0.009000MHz (11.21bits)
 					,	0.000000 * 4.0 * _2(21)	// Freq offset value is 0.000000MHz (11.21bits)
@@ -505,10 +526,182 @@ uint8_t		selectedFilters[2];					// Contains info on which filters are selected,
 
 uint8_t		I2CErrors;							// Indicate timeout (no response) on I2C bus
 
+#if USB_SNAPSHOT_CMD							// Consistent measurement snapshot, USB Cmd 0x62
+snapshot_t	snapshot[2];						// Double buffered measurement snapshot
+uint8_t		snapshot_active;					// Snapshot returned by Cmd 0x62, the other one is
+												// being filled in
+#endif
+
+#if USB_TELEMETRY								// Interrupt IN endpoint telemetry stream
+telemetry_t	telemetry;							// Telemetry record, sent by USB-EP0.c
+uint8_t		telemetry_ready;					// A new telemetry record is waiting to be sent
+uint8_t		telemetry_period[2] = { TELEMETRY_RX, TELEMETRY_TX };// Interval during RX and TX (x 10ms)
+#endif
+
+
+#if USB_CONFIG_IMAGE							// Dump and restore the EEPROM settings image
+uint8_t		config_ref;							// First byte of the image, as written by Cmd 0x37
+uint16_t	config_commit;						// Next byte to rewrite after a failed restore, 0 = idle
+#endif
+
+#if USB_BATCH_CMD								// Batch of sub-commands in one transfer
+uint8_t		batchReply[BATCH_REPLY_SIZE];		// Concatenated results of the last batch, read by Cmd 0x46
+uint8_t		batchReplyLen;						// Number of bytes in batchReply
+
+static void usbBatch(uint8_t *, uint8_t);
+#endif
+
+#if USB_TIMED_FREQ								// Frequency change on a given USB frame
+uint32_t	timed_freq;							// Frequency to write, set by Cmd 0x48
+uint16_t	timed_frame;						// USB frame number in which to write it
+uint16_t	timed_applied;						// USB frame number in which it was written
+uint8_t		timed_pending;						// True until written
+#endif
+
+#if CW_KEY_EVENTS								// Timestamped CW key and PTT edges, USB Cmd 0x52
+cw_event_t	cw_events[CW_EVENTS_LEN];			// Queue of CW key and PTT edges
+volatile uint8_t cw_in;							// Queue in pointer, written by cw_edge()
+uint8_t		cw_out;								// Queue out pointer, written by Cmd 0x52
+uint8_t		cw_overflow;						// Edges lost since the last Cmd 0x52
+uint8_t		cw_state;							// Debounced state, as last queued
+uint16_t	cw_time[2];							// Time of the last accepted edge of each key
+#endif
+
+#if USB_HOP_LIST								// Firmware timed frequency hop list
+hop_t		hop_list[HOP_LIST_LEN];				// Hop list, loaded with Cmd 0x4a
+uint8_t		hop_mode;							// HOP_ONCE/HOP_REPEAT/HOP_NOTIFY, 0 = stopped
+uint8_t		hop_len;							// Number of entries in use
+uint8_t		hop_entry;							// Current entry
+uint16_t	hop_count;							// Number of hops since start
+#endif
+
 
 #include "pe0fko_FreqFromSi570.c"				// Include code is small size and it compiles smaller this way
 
 
+#if USB_DEFERRED_CMD							// Defer USB triggered EEPROM writes and I2C traffic
+usbCmd_t	usbCmdQ[USB_CMDQ_LEN];				// Queue of deferred USB commands
+uint8_t		usbCmdQ_in, usbCmdQ_out;			// Queue in and out pointers
+
+// EEPROM writes by usbFunctionSetup() are queued, the RAM copy (R) is updated immediately
+#define usb_eeprom_write(src, dst, size)	usbCmdPut(USBQ_EEPROM, (uint16_t)(dst), (src), (size))
+#else
+#define usb_eeprom_write(src, dst, size)	eeprom_write_block((src), (dst), (size))
+#endif
+
+
+#if USB_DEFERRED_CMD							// Defer USB triggered EEPROM writes and I2C traffic
+//
+//-----------------------------------------------------------------------------------------
+//			Deferred USB command queue
+//
+//			usbFunctionSetup() captures the slow part of a command (EEPROM writes
+//			and I2C transactions) into this queue and returns at once.  The queue
+//			is emptied by maintask().  Cmds 0x30 - 0x36 are not queued, as
+//			usbFunctionWrite() is only called after the status stage has been
+//			completed (Endpoint_ClearIN() in USB-EP0.c).
+//-----------------------------------------------------------------------------------------
+//
+static void usbCmdExecute(void)					// Execute the oldest command in the queue
+{
+	usbCmd_t *q = &usbCmdQ[usbCmdQ_out];
+
+	switch (q->cmd)
+	{
+		case USBQ_EEPROM:						// Write to EEPROM
+			eeprom_write_block(q->data, (void *)q->addr, q->len);
+			break;
+
+		case USBQ_PCF:							// Write a byte to a PCF8574 GPIO Extender
+			pcf8574_byte(q->addr, q->data[0]);
+			break;
+
+		case USBQ_MOBO_PCF:						// Write out the current builtin PCF8574 data
+			pcf8574_byte(R.PCF_I2C_Mobo_addr, pcf_data_out);
+			break;
+	}
+	usbCmdQ_out = (usbCmdQ_out + 1) % USB_CMDQ_LEN;
+}
+
+static void usbCmdFlush(void)					// Execute all queued commands
+{
+	while (usbCmdQ_out != usbCmdQ_in)
+		usbCmdExecute();
+}
+
+static void usbCmdPut(uint8_t cmd, uint16_t addr, void *data, uint8_t len)
+{
+	uint8_t next = (usbCmdQ_in + 1) % USB_CMDQ_LEN;
+
+	if (next == usbCmdQ_out)					// Queue full, make room by executing
+		usbCmdExecute();						// the oldest command now
+
+	usbCmdQ[usbCmdQ_in].cmd = cmd;
+	usbCmdQ[usbCmdQ_in].len = len;
+	usbCmdQ[usbCmdQ_in].addr = addr;
+	memcpy(usbCmdQ[usbCmdQ_in].data, data, len);
+	usbCmdQ_in = next;
+}
+#endif
+
+
+#if USB_CONFIG_IMAGE							// Dump and restore the EEPROM settings image
+//
+//-----------------------------------------------------------------------------------------
+//			CRC-CCITT of the settings image in EEPROM
+//
+//			The first byte (EEPROM_init_check) is passed in, as it is kept invalid
+//			in EEPROM while an image is being restored
+//-----------------------------------------------------------------------------------------
+//
+static uint16_t configCRC(uint8_t first)
+{
+	uint16_t crc = _crc_ccitt_update(0xffff, first);
+
+	for (uint16_t i = 1; i < sizeof(E); i++)
+		crc = _crc_ccitt_update(crc, eeprom_read_byte((uint8_t *)&E + i));
+	return crc;
+}
+
+static void configInvalidate(void)				// Mark the settings in EEPROM invalid
+{
+	config_commit = 0;							// Stop any rewrite in progress
+	if (eeprom_read_byte(&E.EEPROM_init_check) == R.EEPROM_init_check)
+		eeprom_write_byte(&E.EEPROM_init_check, ~R.EEPROM_init_check);
+}
+
+//
+//-----------------------------------------------------------------------------------------
+//			Rewrite the EEPROM with the settings in use, after a failed restore
+//
+//			Called by maintask() on every pass.  Only bytes which differ are written,
+//			at most one per call, and only once the previous write has completed, so
+//			the mainloop is never held up.  EEPROM_init_check is written last, so
+//			that a reset part way through leaves the settings marked invalid
+//-----------------------------------------------------------------------------------------
+//
+static void configCommit(void)
+{
+	uint16_t i;
+
+	while (config_commit && eeprom_is_ready())
+	{
+		i = config_commit++;
+		if (i == sizeof(E))						// All other bytes done, now mark valid
+		{
+			i = 0;
+			config_commit = 0;
+		}
+		if (eeprom_read_byte((uint8_t *)&E + i) != ((uint8_t *)&R)[i])
+		{
+			eeprom_write_byte((uint8_t *)&E + i, ((uint8_t *)&R)[i]);
+			break;
+		}
+	}
+}
+#endif
+
+
 //
 //-----------------------------------------------------------------------------------------
 //			Process USB Host to Device transmissions.  No result is returned.
@@ -642,6 +835,9 @@ void usbFunctionWrite(USB_Notification_Header_t *rq, uint8_t *data, uint8_t len)
 					R.Encoder_Resolution = *(uint32_t*)data;
 					eeprom_write_block(data, &E.Encoder_Resolution, sizeof(E.Encoder_Resolution));
 					Status2 |= ENC_RES;
+					#if ENCODER_INT_STYLE && ENCODER_RESOLUTION
+					encoder_resolution_update();
+					#endif
 				}
 			}
 		#elif PSDR_IQ_OFFSET36 && !ENCODER_CMD_INCR// Display a fixed frequency offset during RX only.
@@ -654,6 +850,90 @@ void usbFunctionWrite(USB_Notification_Header_t *rq, uint8_t *data, uint8_t len)
 				}												
 			}
 		#endif
+
+		#if USB_CONFIG_IMAGE					// Dump and restore the EEPROM settings image
+		case 0x37:								// Write a chunk of a settings image to EEPROM
+												// Index = offset into the image
+			if (len && (rq->wIndex.w < sizeof(E)) && (len <= sizeof(E) - rq->wIndex.w))
+			{
+				uint16_t offset = rq->wIndex.w;
+
+				configInvalidate();				// Keep EEPROM marked invalid until the
+												// CRC has been checked by Cmd 0x45
+				if (offset == 0)				// The first byte is kept apart, for the
+				{								// CRC and the COLDSTART_REF check
+					config_ref = *data++;
+					len--;
+					offset++;
+				}
+				eeprom_write_block(data, (uint8_t *)&E + offset, len);
+			}
+			break;
+		#endif
+
+		#if USB_BATCH_CMD						// Batch of sub-commands in one transfer
+		case 0x38:								// Execute a batch of sub-commands
+			usbBatch(data, len);
+			break;
+		#endif
+
+		#if USB_TIMED_FREQ						// Frequency change on a given USB frame
+		case 0x48:								// Set frequency by value, written to the Si570
+												// by maintask() in USB frame number Index
+			if (len == 4) {
+				timed_freq = *(uint32_t*)data;
+				timed_frame = rq->wIndex.w & 0x7ff;
+				timed_pending = True;
+			}
+			break;
+		#endif
+
+		#if USB_HOP_LIST						// Firmware timed frequency hop list
+		case 0x4a:								// Load hop list entries, from entry Index onwards,
+												// data = 1 - 4x frequency and dwell time in ms
+			if (len && !(len % sizeof(hop_t)) && (rq->wIndex.b0 + len / sizeof(hop_t) <= HOP_LIST_LEN))
+				memcpy(&hop_list[rq->wIndex.b0], data, len);
+			break;
+		#endif
+
+		#if SWR_SWEEP							// SWR sweep
+		case 0x4c:								// Start an SWR sweep, data = start frequency and
+												// frequency step, Index = number of points (low
+												// byte) and settle time in ms (high byte)
+			if ((len == 2*sizeof(uint32_t)) && (sweep_state < SWEEP_TUNE)
+				&& rq->wIndex.b0 && (rq->wIndex.b0 <= SWEEP_POINTS)
+				&& !(Status1 & (TX_FLAG | TMP_ALARM | PA_CAL)))
+			{
+				memcpy(&sweep_freq, data, sizeof(uint32_t));
+				memcpy(&sweep_step, data+4, sizeof(uint32_t));
+				sweep_points = rq->wIndex.b0;
+				sweep_settle = rq->wIndex.b1;
+				sweep_done = 0;
+				sweep_restore = R.Freq[0];
+				biasInit = 0;					// Ensure that correct bias is set by PA_bias()
+				sweep_state = SWEEP_TUNE;		// Go, sweep is run by maintask()
+			}
+			break;
+		#endif
+
+		#if POWER_SWR && PWR_CAL_TABLE			// Power calibration table
+		case 0x4f:								// Load a power calibration point, data = AD
+												// reading (16 bits) and mW (32 bits), Index =
+												// band (low byte) and point (high byte), Value =
+												// number of points in the band table (0 = none)
+			if ((len == sizeof(uint16_t) + sizeof(uint32_t)) && (rq->wIndex.b0 < PWR_CAL_BANDS)
+				&& (rq->wIndex.b1 < PWR_CAL_POINTS) && (rq->wValue.b0 <= PWR_CAL_POINTS))
+			{
+				pwr_cal_t point;
+				point.adc = *(uint16_t*)data;
+				point.mw = pwr_cal_pack(*(uint32_t*)(data+2));
+				usb_eeprom_write(&point, &E_PwrCal[rq->wIndex.b0][rq->wIndex.b1], sizeof(pwr_cal_t));
+				usb_eeprom_write(&rq->wValue.b0, &E.PWR_Cal_Points[rq->wIndex.b0], sizeof (uint8_t));
+				R.PWR_Cal_Points[rq->wIndex.b0] = rq->wValue.b0;
+				pwr_cal_point(rq->wIndex.b0, rq->wIndex.b1, &point);// Into the band table in use
+			}
+			break;
+		#endif
 	}
 }
 
@@ -784,7 +1064,7 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
 					{
 					R.FilterCrossOver[index].w = rq->wValue.w;
 
-					eeprom_write_block(&R.FilterCrossOver[index].w, 
+					usb_eeprom_write(&R.FilterCrossOver[index].w, 
 						&E.FilterCrossOver[index].w, 
 						sizeof(E.FilterCrossOver[0].w));
 					}
@@ -799,7 +1079,7 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
 					{
 						R.TXFilterCrossOver[index].w = rq->wValue.w;
 
-						eeprom_write_block(&R.TXFilterCrossOver[index].w, 
+						usb_eeprom_write(&R.TXFilterCrossOver[index].w, 
 							&E.TXFilterCrossOver[index].w, 
 							sizeof(E.TXFilterCrossOver[0].w));
 					}
@@ -811,7 +1091,7 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
 
 		#if SCRAMBLED_FILTERS					// Enable a non contiguous order of filters
 		case 0x18:								// Set the Band Pass Filter Address for one band: 0,1,2...7
-			eeprom_write_block(&rq->wValue.b0, &E.FilterNumber[index & 0x03], sizeof (uint8_t));
+			usb_eeprom_write(&rq->wValue.b0, &E.FilterNumber[index & 0x03], sizeof (uint8_t));
 			R.FilterNumber[index & 0x03] = rq->wValue.b0;
 			// passthrough to case 0x19
 
@@ -821,7 +1101,7 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
 
 
 		case 0x1a:								// Set the Low Pass Filter Address for one band: 0,1,2...15
-			eeprom_write_block(&rq->wValue.b0, &E.TXFilterNumber[index & 0x07], sizeof (uint8_t));
+			usb_eeprom_write(&rq->wValue.b0, &E.TXFilterNumber[index & 0x07], sizeof (uint8_t));
 			R.TXFilterNumber[index & 0x03] = rq->wValue.b0;
 
 
@@ -878,6 +1158,9 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
 
 
 		case 0x3c:								// Return the startup frequency
+			#if USB_DEFERRED_CMD				// Defer USB triggered EEPROM writes and I2C traffic
+			usbCmdFlush();						// Make sure any pending EEPROM write is done
+			#endif
 			eeprom_read_block(replyBuf, &E.Freq[index], sizeof(E.Freq[index]));
 			return sizeof(uint32_t);
 
@@ -893,6 +1176,14 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
         
  
 		case 0x3f:								// read out chip frequency control registers
+			#if USB_DEFERRED_CMD				// Defer USB triggered EEPROM writes and I2C traffic
+			if (!(Status2 & SI570_OFFL))		// Return the registers as last written to the Si570
+			{
+				usbMsgPtr = (uint8_t*)&Si570_Data;
+				return sizeof(Si570_t);
+			}
+			usbCmdFlush();
+			#endif
 			return GetRegFromSi570();			// read all registers in one block to replyBuf[]
 
 
@@ -919,7 +1210,7 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
         	{
 				// Force an EEPROM update:
 				// eeprom_write_block appears to take (14 bytes) less pgm space than eeprom_write_byte 
-				eeprom_write_block(&rq->wValue.b0, &E.EEPROM_init_check, sizeof (uint8_t));
+				usb_eeprom_write(&rq->wValue.b0, &E.EEPROM_init_check, sizeof (uint8_t));
 				Status1 |= REBOOT;				// Reboot by watchdog timer
 				return 0;
 			}
@@ -931,29 +1222,29 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
 				switch (index) 
 				{
 					case 0:
-						eeprom_write_block(&rq->wValue.b0, &E.Si570_I2C_addr, sizeof (uint8_t));
+						usb_eeprom_write(&rq->wValue.b0, &E.Si570_I2C_addr, sizeof (uint8_t));
 						break;
 					case 1:	
-						eeprom_write_block(&rq->wValue.b0, &E.PCF_I2C_Mobo_addr, sizeof (uint8_t));
+						usb_eeprom_write(&rq->wValue.b0, &E.PCF_I2C_Mobo_addr, sizeof (uint8_t));
 						break;
 					case 2:
-						eeprom_write_block(&rq->wValue.b0, &E.PCF_I2C_lpf1_addr, sizeof (uint8_t));
+						usb_eeprom_write(&rq->wValue.b0, &E.PCF_I2C_lpf1_addr, sizeof (uint8_t));
 						break;
 					case 3:
-						eeprom_write_block(&rq->wValue.b0, &E.PCF_I2C_lpf2_addr, sizeof (uint8_t));
+						usb_eeprom_write(&rq->wValue.b0, &E.PCF_I2C_lpf2_addr, sizeof (uint8_t));
 						break;
 					case 4:
-						eeprom_write_block(&rq->wValue.b0, &E.TMP100_I2C_addr, sizeof (uint8_t));
+						usb_eeprom_write(&rq->wValue.b0, &E.TMP100_I2C_addr, sizeof (uint8_t));
 						break;
 					case 5:	
-						eeprom_write_block(&rq->wValue.b0, &E.AD5301_I2C_addr, sizeof (uint8_t));
+						usb_eeprom_write(&rq->wValue.b0, &E.AD5301_I2C_addr, sizeof (uint8_t));
 						break;
 					case 6:
-						eeprom_write_block(&rq->wValue.b0, &E.AD7991_I2C_addr, sizeof (uint8_t));
+						usb_eeprom_write(&rq->wValue.b0, &E.AD7991_I2C_addr, sizeof (uint8_t));
 						break;
 					#if FAN_CONTROL && EXTERN_PCF_FAN	// Fan Control by External PCF8574
 					case 7:
-						eeprom_write_block(&rq->wValue.b0, &E.PCF_I2C_Ext_addr, sizeof (uint8_t));
+						usb_eeprom_write(&rq->wValue.b0, &E.PCF_I2C_Ext_addr, sizeof (uint8_t));
 						break;
 					#endif
 				}
@@ -1004,13 +1295,317 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
 		//#endif
 
 
+		#if USB_CONFIG_IMAGE					// Dump and restore the EEPROM settings image
+		case 0x44:								// Read a chunk of the settings image from EEPROM
+												// Index = offset into the image
+			#if USB_DEFERRED_CMD				// Defer USB triggered EEPROM writes and I2C traffic
+			usbCmdFlush();						// Make sure any pending EEPROM write is done
+			#endif
+			if ((rq->wIndex.w >= sizeof(E)) || config_commit) return 0;
+			{
+				uint8_t len = sizeof(replyBuf);	// Max 32 bytes per chunk
+				if (len > sizeof(E) - rq->wIndex.w) len = sizeof(E) - rq->wIndex.w;
+				eeprom_read_block(replyBuf, (uint8_t *)&E + rq->wIndex.w, len);
+				return len;
+			}
+
+		case 0x45:								// Return size and CRC of the settings image
+												// Index 1: Use the image written with Cmd 0x37
+												// if its CRC matches Value
+			#if USB_DEFERRED_CMD				// Defer USB triggered EEPROM writes and I2C traffic
+			usbCmdFlush();						// Make sure any pending EEPROM write is done
+			#endif
+			if (config_commit) return 0;		// Busy rewriting the EEPROM, try again later
+			replyBuf[0].w = sizeof(E);
+			replyBuf[1].w = configCRC((index == 1) ? config_ref : R.EEPROM_init_check);
+			if (index != 1) return 2 * sizeof(uint16_t);
+
+			// Image OK, and written by a firmware with the same COLDSTART_REF, use it
+			if ((replyBuf[1].w == rq->wValue.w) && (config_ref == R.EEPROM_init_check))
+			{
+				uint32_t freq = R.Freq[0];		// Keep the running frequency
+				#if PWR_CAL_TABLE				// The band tables are not part of the image,
+				uint8_t points[PWR_CAL_BANDS];	// so keep the number of points in each
+				memcpy(points, R.PWR_Cal_Points, sizeof(points));
+				#endif
+				eeprom_read_block(&R, &E, sizeof(E));
+				R.EEPROM_init_check = config_ref;
+				R.Freq[0] = freq;
+				#if PWR_CAL_TABLE
+				memcpy(R.PWR_Cal_Points, points, sizeof(points));
+				for (uint8_t i = 0; i < PWR_CAL_BANDS; i++)
+					if (eeprom_read_byte(&E.PWR_Cal_Points[i]) != points[i])
+						eeprom_write_byte(&E.PWR_Cal_Points[i], points[i]);
+				#endif
+				eeprom_write_byte(&E.EEPROM_init_check, R.EEPROM_init_check);// Valid, last
+				#if POWER_SWR && (FAST_METERING || SWR_FAST_TRIP)// Precalculated metering constants
+				meter_update();
+				#endif
+				#if CW_KEYER					// Iambic keyer
+				keyer_update();
+				#endif
+				#if ENCODER_INT_STYLE && ENCODER_RESOLUTION
+				encoder_resolution_update();
+				#endif
+				#if PWR_CAL_TABLE				// Piecewise linear power calibration
+				pwr_cal_reload();
+				#endif
+				replyBuf[2].w = True;
+			}
+			else								// Rejected, rewrite EEPROM with the settings
+			{									// in use, done by maintask()
+				configInvalidate();
+				config_commit = 1;
+				replyBuf[2].w = False;
+			}
+			return 3 * sizeof(uint16_t);
+		#endif
+
+
+		#if USB_BATCH_CMD						// Batch of sub-commands in one transfer
+		case 0x46:								// Return the concatenated results of the last
+			usbMsgPtr = batchReply;				// batch of sub-commands (Cmd 0x38)
+			return batchReplyLen;
+		#endif
+
+
+		#if CW_KEY_EVENTS						// Timestamped CW key and PTT edges
+		case 0x52:								// Return the current time (TCNT1), number of
+												// edges, a flag for lost edges, and up to 9 queued
+												// CW key and PTT edges, each time and state
+			{
+				uint8_t n = 0;
+				uint8_t *p = (uint8_t *)&replyBuf[2];
+
+				while ((cw_out != cw_in) && (n < 9))
+				{
+					memcpy(p, &cw_events[cw_out], sizeof(cw_event_t));
+					p += sizeof(cw_event_t);
+					cw_out = (cw_out + 1) & (CW_EVENTS_LEN - 1);
+					n++;
+				}
+				replyBuf[0].w = TCNT1;
+				replyBuf[1].b0 = n;
+				replyBuf[1].b1 = cw_overflow;
+				cw_overflow = False;
+				return 2 * sizeof(uint16_t) + n * sizeof(cw_event_t);
+			}
+		#endif
+
+
+		#if CW_KEYER							// Iambic keyer
+		case 0x53:								// Read/Modify a keyer parameter
+												// Index low byte = parameter: 0 = mode, 1 = WPM,
+												// 2 = weight, 3 = PTT hang time (10ms units)
+												// If Index high byte = 1, then the parameter is
+												// set to Value
+			if (index >= KEYER_PARAMS) return 0;
+			if (rq->wIndex.b1 == 1)
+			{
+				usb_eeprom_write(&rq->wValue.b0, &E.Keyer[index], sizeof (uint8_t));
+				R.Keyer[index] = rq->wValue.b0;
+				keyer_update();
+			}
+			replyBuf[0].b0 = R.Keyer[index];
+			return sizeof(uint8_t);
+		#endif
+
+
+		#if TR_SEQUENCER						// T/R sequencer
+		case 0x54:								// Read/Modify a T/R sequencer parameter
+												// Index low byte = parameter: 0 - 4 = delay in ms
+												// before each TX step, 5 - 9 = delay before each
+												// RX step, 10 = RX mute bits, 11 = antenna relay
+												// bits.  If Index high byte = 1, then the parameter
+												// is set to Value
+			if (index >= TR_PARAMS) return 0;
+			if (rq->wIndex.b1 == 1)
+			{
+				if ((index < TR_MUTE_BITS) && (rq->wValue.b0 > TR_DELAY_MAX))
+					rq->wValue.b0 = TR_DELAY_MAX;
+				usb_eeprom_write(&rq->wValue.b0, &E.TR_Seq[index], sizeof (uint8_t));
+				R.TR_Seq[index] = rq->wValue.b0;
+			}
+			replyBuf[0].b0 = R.TR_Seq[index];
+			return sizeof(uint8_t);
+
+		case 0x55:								// Return the duration of the last TX and RX
+												// sequences (1/62500 s), the number of TX steps
+												// in effect, and the steps for the current PTT
+			replyBuf[0].w = tr_measured[0];
+			replyBuf[1].w = tr_measured[1];
+			replyBuf[2].b0 = tr_pos;
+			replyBuf[2].b1 = tr_target;
+			return 3 * sizeof(uint16_t);
+		#endif
+
+
+		#if POWER_SWR && SWR_ALARM_FUNC && SWR_FAST_TRIP// Fast SWR trip
+		case 0x56:								// Return the reaction time of the last fast SWR
+												// trip (1/62500 s), the number of trips, and the
+												// number of samples over the threshold to trip.
+												// If Index = 1, then the number of samples is set
+												// to Value (1 - 255), if Index = 2, then the
+												// reaction time and number of trips are cleared
+			if ((index == 1) && rq->wValue.b0)
+			{
+				usb_eeprom_write(&rq->wValue.b0, &E.SWR_Trip_Count, sizeof (uint8_t));
+				R.SWR_Trip_Count = rq->wValue.b0;
+			}
+			if (index == 2)
+				swr_trip_time = swr_trips = 0;
+			replyBuf[0].w = swr_trip_time;
+			replyBuf[1].w = swr_trips;
+			replyBuf[2].w = R.SWR_Trip_Count;
+			return 3 * sizeof(uint16_t);
+		#endif
+
+
+		#if POWER_SWR && PEP_METER				// PEP, average and peak hold
+		case 0x57:								// Return PEP, average power and peak hold, in mW.
+												// If Index = 1, then the peak hold is cleared
+			if (index == 1)
+				pep_hold = 0;
+			replyBuf[0].w = pep_power;
+			replyBuf[1].w = pep_average();
+			replyBuf[2].w = pep_hold;
+			return 3 * sizeof(uint16_t);
+		#endif
+
+
+		#if BIAS_FAST_CAL						// Fast PA bias calibration
+		case 0x58:								// Return the PA bias calibration status, number of
+												// readings, bias setting being measured, last PA
+												// current reading, and the LO and HI bias settings.
+												// If Index = 1, then the settle time before each
+												// reading is set to Value (1 - 255, in 10ms).
+												// The calibration is started with Cmd 0x65
+			if ((index == 1) && rq->wValue.b0)
+			{
+				usb_eeprom_write(&rq->wValue.b0, &E.Bias_Settle, sizeof (uint8_t));
+				R.Bias_Settle = rq->wValue.b0;
+			}
+			replyBuf[0].b0 = bias_cal_status;
+			replyBuf[0].b1 = bias_cal_steps;
+			replyBuf[1].b0 = bias_cal_probe;
+			replyBuf[1].b1 = bias_cal_current;
+			replyBuf[2].b0 = R.cal_LO;
+			replyBuf[2].b1 = R.cal_HI;
+			replyBuf[3].b0 = R.Bias_Settle;
+			return 7 * sizeof(uint8_t);
+		#endif
+
+
+		#if ADC_DECIMATE						// AD7991 decimation filter
+		case 0x59:								// Read/Modify the decimation of an AD7991 channel,
+												// Index low byte = channel (0 - 3), 2^Value
+												// readings are summed into each value.  If Index
+												// high byte = 1, then it is set to Value (0 - 4)
+			if (index > AD7991_PSU_VOLTAGE) return 0;
+			if (rq->wIndex.b1 == 1)
+			{
+				if (rq->wValue.b0 > ADC_DECIMATE_MAX)
+					rq->wValue.b0 = ADC_DECIMATE_MAX;
+				usb_eeprom_write(&rq->wValue.b0, &E.ADC_Decimate[index], sizeof (uint8_t));
+				R.ADC_Decimate[index] = rq->wValue.b0;
+			}
+			replyBuf[0].b0 = R.ADC_Decimate[index];
+			return sizeof(uint8_t);
+		#endif
+
+
+		#if POWER_SWR && PWR_CAL_TABLE			// Power calibration table
+		case 0x5a:								// Return a power calibration point, AD reading
+												// and mW as stored, and the number of points in
+												// the band table.  Index = band (low byte) and
+												// point (high byte)
+			if ((index >= PWR_CAL_BANDS) || (rq->wIndex.b1 >= PWR_CAL_POINTS)) return 0;
+			{
+				pwr_cal_t point;
+				eeprom_read_block(&point, &E_PwrCal[index][rq->wIndex.b1], sizeof(pwr_cal_t));
+				replyBuf[0].w = point.adc;
+				*(uint32_t*)&replyBuf[1] = pwr_cal_unpack(point.mw);
+				replyBuf[3].b0 = R.PWR_Cal_Points[index];
+			}
+			return sizeof(uint16_t) + sizeof(uint32_t) + sizeof(uint8_t);
+
+		case 0x5b:								// Return the power out and the reflected power
+												// in mW (32 bits), and the band table in use
+			*(uint32_t*)&replyBuf[0] = cal_Power(ad7991_adc[AD7991_POWER_OUT].w);
+			*(uint32_t*)&replyBuf[2] = cal_Power(ad7991_adc[AD7991_POWER_REF].w);
+			replyBuf[4].b0 = pwr_cal_band;
+			return 2 * sizeof(uint32_t) + sizeof(uint8_t);
+		#endif
+
+
+		#if USB_TIMED_FREQ						// Frequency change on a given USB frame
+		case 0x49:								// Return the current USB frame number, the frame
+												// number in which the last Cmd 0x48 frequency was
+												// written to the Si570, and True if still pending
+			replyBuf[0].w = UDFNUM & 0x7ff;
+			replyBuf[1].w = timed_applied;
+			replyBuf[2].w = timed_pending;
+			return 3 * sizeof(uint16_t);
+		#endif
+
+
+		#if USB_HOP_LIST						// Firmware timed frequency hop list
+		case 0x4b:								// Start/Stop the hop list, and return its status
+												// Value 0 = stop, HOP_ONCE or HOP_REPEAT = start,
+												// with the number of entries in Index.
+												// Value 0xff = return status only
+			if (rq->wValue.b0 != 0xff)
+			{
+				hop_mode = 0;
+				if ((rq->wValue.b0 & (HOP_ONCE | HOP_REPEAT)) && index && (index <= HOP_LIST_LEN))
+				{
+					hop_len = index;
+					hop_entry = 0xff;			// First hop, to entry 0, on the next mainloop pass
+					hop_count = 0;
+					hop_mode = rq->wValue.b0;
+				}
+			}
+			replyBuf[0].w = hop_mode;
+			replyBuf[1].w = hop_entry;
+			replyBuf[2].w = hop_count;
+			return 3 * sizeof(uint16_t);
+		#endif
+
+
+		#if SWR_SWEEP							// SWR sweep
+		case 0x4d:								// Return status of the SWR sweep: state (0 = idle
+												// or completed, 1 = aborted, 2 or more = running)
+												// and number of points measured.
+												// Value 1 stops a running sweep
+			if ((rq->wValue.b0 == 1) && (sweep_state >= SWEEP_TUNE))
+				sweep_state = SWEEP_STOP;
+			replyBuf[0].w = sweep_state;
+			replyBuf[1].w = sweep_done;
+			return 2 * sizeof(uint16_t);
+
+		case 0x4e:								// Return the measured SWR x 10 of each point,
+												// up to 32 points from point number Index
+			if (index >= sweep_done) return 0;
+			usbMsgPtr = &sweep_swr[index];
+			return (sweep_done - index > 32) ? 32 : sweep_done - index;
+		#endif
+
+
 		case 0x50:								//Set/Release PTT and get cw-key status
+			#if TR_SEQUENCER					// T/R sequence, the steps are done by maintask()
+			tr_ptt(rq->wValue.b0);
+			#else
 			if (rq->wValue.b0 == 0)
 			{
 				// Clear PTT flag
 				Status1 = Status1 & ~TX_FLAG;
 				#if MOBO_STYLE_IO
+				#if USB_DEFERRED_CMD			// Update output data now, write to the PCF8574 later
+				pcf_data_out |= Mobo_PCF_TX;
+				usbCmdPut(USBQ_MOBO_PCF, 0, 0, 0);
+				#else
 				MoboPCF_set(Mobo_PCF_TX);
+				#endif
 				#endif//MOBO_STYLE_IO
 				#if OLDSTYLE_IO
 				IO_PORT_PTT_CWKEY &= ~IO_PTT;
@@ -1028,13 +1623,19 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
 					
 					// Switch to Transmit mode, set TX out
 					#if MOBO_STYLE_IO
+					#if USB_DEFERRED_CMD		// Update output data now, write to the PCF8574 later
+					pcf_data_out &= ~Mobo_PCF_TX;
+					usbCmdPut(USBQ_MOBO_PCF, 0, 0, 0);
+					#else
 					MoboPCF_clear(Mobo_PCF_TX);
+					#endif
 					#endif//MOBO_STYLE_IO
 					#if OLDSTYLE_IO
 					IO_PORT_PTT_CWKEY |= IO_PTT;
 					#endif//OLDSTYLE_IO
 				}
 			}
+			#endif//TR_SEQUENCER
 			// Passthrough to Cmd 0x51
 /*
 		case 0x51:								// read CW key levels
@@ -1054,6 +1655,9 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
 			if (IO_PIN_PTT_CWKEY & IO_CWKEY2) replyBuf[0].b0 |= REG_CWLONG;
 			// read current PTT state and set regbit accordingly
 			if (Status1 & TX_FLAG) replyBuf[0].b0 |= REG_TX_state;
+			#if CW_KEYER
+			if (keyer_key) replyBuf[0].b0 |= REG_KEY_DOWN;
+			#endif
         	return sizeof(uint8_t);
 
 
@@ -1077,6 +1681,28 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
 			}
 			return sizeof(uint16_t);
 
+
+		#if USB_SNAPSHOT_CMD					// Consistent measurement snapshot
+		case 0x62:		// Read a snapshot of all measurements, taken in the same 10ms slot
+						// The reply is the snapshot_t record, see README for the layout
+
+			usbMsgPtr = (uint8_t*)&snapshot[snapshot_active];
+			return sizeof(snapshot_t);
+		#endif
+
+
+		#if USB_TELEMETRY						// Interrupt IN endpoint telemetry stream
+		case 0x63:		// Read/Modify the telemetry stream interval, in units of 10ms
+						// Index 0: Interval during RX
+						// Index 1: Interval during TX
+						// If Value > 0, then the interval is updated
+
+			if (index > 1) return 0;
+			if (rq->wValue.b0) telemetry_period[index] = rq->wValue.b0;
+			replyBuf[0].b0 = telemetry_period[index];
+			return sizeof(uint8_t);
+		#endif
+
  
 		case 0x64:		// Read/Modify the PA High Temperature limit
 						// If wValue contains a value higher than 0,
@@ -1096,20 +1722,20 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
 				switch (index) 
 				{
 					case 0:
-						eeprom_write_block(&rq->wValue.b0, &E.hi_tmp_trigger, sizeof (uint8_t));
+						usb_eeprom_write(&rq->wValue.b0, &E.hi_tmp_trigger, sizeof (uint8_t));
 						R.hi_tmp_trigger = rq->wValue.b0;
 						break;
 					case 1:
-						eeprom_write_block(&rq->wValue.b0, &E.Fan_On, sizeof (uint8_t));
+						usb_eeprom_write(&rq->wValue.b0, &E.Fan_On, sizeof (uint8_t));
 						R.Fan_On = rq->wValue.b0;
 						break;
 					case 2:
-						eeprom_write_block(&rq->wValue.b0, &E.Fan_Off, sizeof (uint8_t));
+						usb_eeprom_write(&rq->wValue.b0, &E.Fan_Off, sizeof (uint8_t));
 						R.Fan_Off = rq->wValue.b0;
 						break;
 					#if FAN_CONTROL && EXTERN_PCF_FAN	// Fan Control by External PCF8574
 					case 3:
-						eeprom_write_block(&rq->wValue.b0, &E.PCF_fan_bit, sizeof (uint8_t));
+						usb_eeprom_write(&rq->wValue.b0, &E.PCF_fan_bit, sizeof (uint8_t));
 						R.PCF_fan_bit = rq->wValue.b0;
 						break;
 					#endif
@@ -1140,7 +1766,7 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
 			#else
 			if (rq->wValue.b0)
 			{		// New value
-					eeprom_write_block(&rq->wValue.b0, &E.hi_tmp_trigger, sizeof (uint8_t));
+					usb_eeprom_write(&rq->wValue.b0, &E.hi_tmp_trigger, sizeof (uint8_t));
 					R.hi_tmp_trigger = rq->wValue.b0;
 			}
 			// Return current value
@@ -1164,26 +1790,26 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
 				switch (index) 
 				{
 					case 0:						// Which bias, 0 = Cal, 1 = LO, 2 = HI
-						eeprom_write_block(&rq->wValue.b0, &E.Bias_Select, sizeof (uint8_t));
+						usb_eeprom_write(&rq->wValue.b0, &E.Bias_Select, sizeof (uint8_t));
 						replyBuf[0].b0 = R.Bias_Select = rq->wValue.b0;
 						break;
 	
 					case 1:						// PA Bias in 10 * mA, Low bias setting
-						eeprom_write_block(&rq->wValue.b0, &E.Bias_LO, sizeof (uint8_t));
+						usb_eeprom_write(&rq->wValue.b0, &E.Bias_LO, sizeof (uint8_t));
 						replyBuf[0].b0 = R.Bias_LO = rq->wValue.b0;
 						break;
 					case 2:						// PA Bias in 10 * mA, High bias setting
-						eeprom_write_block(&rq->wValue.b0, &E.Bias_HI, sizeof (uint8_t));
+						usb_eeprom_write(&rq->wValue.b0, &E.Bias_HI, sizeof (uint8_t));
 						replyBuf[0].b0 = R.Bias_HI = rq->wValue.b0;
 						break;
 
 					case 3:						// PA Bias setting, Low bias setting
-						eeprom_write_block(&rq->wValue.b0, &E.cal_LO, sizeof (uint8_t));
+						usb_eeprom_write(&rq->wValue.b0, &E.cal_LO, sizeof (uint8_t));
 						replyBuf[0].b0 = R.cal_LO = rq->wValue.b0;
 						break;
 
 					case 4:						// PA Bias setting, High bias setting
-						eeprom_write_block(&rq->wValue.b0, &E.cal_HI, sizeof (uint8_t));
+						usb_eeprom_write(&rq->wValue.b0, &E.cal_HI, sizeof (uint8_t));
 						replyBuf[0].b0 = R.cal_HI = rq->wValue.b0;
 						break;
 				}
@@ -1229,41 +1855,44 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
 				switch (index) 
 				{
 					case 0:						// Min P out measurement for SWR trigger
-						eeprom_write_block(&rq->wValue.w, &E.P_Min_Trigger, sizeof (E.P_Min_Trigger));
+						usb_eeprom_write(&rq->wValue.w, &E.P_Min_Trigger, sizeof (E.P_Min_Trigger));
 						replyBuf[0].w = R.P_Min_Trigger = rq->wValue.w;
 						break;
 	
 					case 1:						// Timer loop value
-						eeprom_write_block(&rq->wValue.w, &E.SWR_Protect_Timer, sizeof (E.SWR_Protect_Timer));
+						usb_eeprom_write(&rq->wValue.w, &E.SWR_Protect_Timer, sizeof (E.SWR_Protect_Timer));
 						replyBuf[0].w = R.SWR_Protect_Timer = rq->wValue.w;
 						break;
 					case 2:						// Max SWR threshold
-						eeprom_write_block(&rq->wValue.w, &E.SWR_Trigger, sizeof (E.SWR_Trigger));
+						usb_eeprom_write(&rq->wValue.w, &E.SWR_Trigger, sizeof (E.SWR_Trigger));
 						replyBuf[0].w = R.SWR_Trigger = rq->wValue.w;
 						break;
 					case 3:						// Max SWR threshold
-						eeprom_write_block(&rq->wValue.w, &E.PWR_Calibrate, sizeof (E.PWR_Calibrate));
+						usb_eeprom_write(&rq->wValue.w, &E.PWR_Calibrate, sizeof (E.PWR_Calibrate));
 						replyBuf[0].w = R.PWR_Calibrate = rq->wValue.w;
 						break;
 					#if BARGRAPH
 					case 4:						// Fullscale Power Bargraph value
-						eeprom_write_block(&rq->wValue.b0, &E.PWR_fullscale, sizeof (E.PWR_fullscale));
+						usb_eeprom_write(&rq->wValue.b0, &E.PWR_fullscale, sizeof (E.PWR_fullscale));
 						replyBuf[0].b0 = R.PWR_fullscale = rq->wValue.b0;
 						break;
 					#if	BARGRAPH_SWR_SCALE		// Add option to adjust the Fullscale value for the SWR bargraph
 					case 5:						// Fullscale SWR Bargraph value
-						eeprom_write_block(&rq->wValue.b0, &E.SWR_fullscale, sizeof (E.SWR_fullscale));
+						usb_eeprom_write(&rq->wValue.b0, &E.SWR_fullscale, sizeof (E.SWR_fullscale));
 						replyBuf[0].b0 = R.SWR_fullscale = rq->wValue.b0;
 						break;
 					#endif
 					#endif
 					#if	PWR_PEP_ADJUST			// Add option to adjust the number of samples in PEP measurement
 					case 6:						// Number of samples in PEP measurement
-						eeprom_write_block(&rq->wValue.b0, &E.PEP_samples, sizeof (E.PEP_samples));
+						usb_eeprom_write(&rq->wValue.b0, &E.PEP_samples, sizeof (E.PEP_samples));
 						replyBuf[0].b0 = R.PEP_samples = rq->wValue.b0;
 						break;
 					#endif
 				}
+				#if POWER_SWR && (FAST_METERING || SWR_FAST_TRIP)// Precalculated metering constants
+				meter_update();					// Calibration or trigger may have changed
+				#endif
 			}
 
 			else								// Else just read and return the current value
@@ -1308,8 +1937,11 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
 									// Normally set to the number of resolvable states per revolution
 			if (rq->wValue.w)
 			{		// New value
-					eeprom_write_block(&rq->wValue.w, &E.Resolvable_States, sizeof (uint16_t));
+					usb_eeprom_write(&rq->wValue.w, &E.Resolvable_States, sizeof (uint16_t));
 					R.Resolvable_States = rq->wValue.w;
+					#if ENCODER_INT_STYLE	// Interrupt driven Shaft Encoder
+					encoder_resolution_update();
+					#endif
 			}
 			// Return current value
 			replyBuf[0].w = R.Resolvable_States;
@@ -1321,7 +1953,7 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
 		case 0x68:					// Display a fixed frequency offset during RX only.
 			if (index)				// If Index>0, then New value contained in Value
 			{
-				eeprom_write_block(&rq->wValue.b0, &E.LCD_RX_Offset, sizeof (uint8_t));
+				usb_eeprom_write(&rq->wValue.b0, &E.LCD_RX_Offset, sizeof (uint8_t));
 				R.LCD_RX_Offset = rq->wValue.b0;// used frequency, when using PowerSDR-IQ
 			}
 			// Return current value
@@ -1330,18 +1962,71 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
 		#endif		
 
 
+		#if ENCODER_INT_STYLE && (ENCODER_INT_TABLE || ENCODER_FAST_RETUNE)
+		case 0x69:					// Rotary Encoder diagnostics
+									// Index 0: Number of invalid transitions seen by the
+									//          table driven Rotary Encoder decoder
+									// Index 1: Last and max latency from encoder pulse to
+									//          Si570 write, in units of 16us
+									// If Value > 0, then the values are cleared after reading
+			#if ENCODER_FAST_RETUNE				// Write encoder frequency changes without delay
+			if (index == 1)
+			{
+				replyBuf[0].w = enc_latency[0];
+				replyBuf[1].w = enc_latency[1];
+				if (rq->wValue.b0) enc_latency[0] = enc_latency[1] = 0;
+				return 2 * sizeof(uint16_t);
+			}
+			#endif
+			#if ENCODER_INT_TABLE				// Interrupt on both phases, table driven decoder
+			cli();
+			replyBuf[0].w = enc_invalid;
+			if (rq->wValue.b0) enc_invalid = 0;
+			sei();
+			return sizeof(uint16_t);
+			#else
+			return 0;
+			#endif
+		#endif
+
+
+		#if ENCODER_INT_STYLE && ENCODER_ACCEL	// Velocity based acceleration curve
+		case 0x6a:					// Read/Modify a point in the Rotary Encoder acceleration curve
+									// Index = point (0 - 15), fastest first, in significant bits
+									// of the time between encoder pulses (steps of 1/62500 s)
+									// If Value > 0, then the click multiplier is updated
+			if (index >= ENC_ACCEL_STEPS) return 0;
+			if (rq->wValue.b0)
+			{
+				usb_eeprom_write(&rq->wValue.b0, &E.Enc_Accel[index], sizeof (uint8_t));
+				R.Enc_Accel[index] = rq->wValue.b0;
+			}
+			replyBuf[0].b0 = R.Enc_Accel[index];
+			return sizeof(uint8_t);
+		#endif
+
+
 		#if PCF_WRITE_COMMAND					// [Option] Enable command 0x6e for
 
 												// direct control of PCF8574 extenders
 		case 0x6e:								// Send byte to (PCF8574) GPIO Extender
+			#if USB_DEFERRED_CMD				// Defer USB triggered EEPROM writes and I2C traffic
+			usbCmdPut(USBQ_PCF, index, &rq->wValue.b0, sizeof(uint8_t));
+			replyBuf[0].b0 = rq->wValue.b0;		// Return the byte written, rather than reading
+			return sizeof(uint8_t);				// it back from the PCF8574
+			#else
 			pcf8574_byte(index, rq->wValue.b0);
 			// Passthrough to Cmd 0x6f or END XXXXXXXXXXXX
+			#endif
 		#endif
 
 
 		#if PCF_READ_COMMAND					// [Option] Enable command 0x6f for
 												// direct control of PCF8574 extenders
 		case 0x6f:								// Read byte from (PCF8574) GPIO Extender
+			#if USB_DEFERRED_CMD				// Defer USB triggered EEPROM writes and I2C traffic
+			usbCmdFlush();						// Read must reflect any pending write
+			#endif
 			replyBuf[0].b0 = pcf8574_read(index);
 			return sizeof(uint8_t);
 		#endif
@@ -1353,6 +2038,140 @@ unsigned char usbFunctionSetup(USB_Notification_Header_t *rq)
 }
 
 
+#if USB_BATCH_CMD								// Batch of sub-commands in one transfer
+//
+//-----------------------------------------------------------------------------------------
+//			Execute a batch of sub-commands, received with USB Cmd 0x38
+//
+//			Each sub-command is: Cmd, number of data bytes, Value (2 bytes), Index,
+//			followed by the data bytes.  Cmds 0x30 - 0x3f are passed the data bytes,
+//			all other Cmds have their result (length byte + result) added to
+//			batchReply.  A malformed sub-command, or a result which does not fit,
+//			ends the batch.
+//-----------------------------------------------------------------------------------------
+//
+static void usbBatch(uint8_t *data, uint8_t len)
+{
+	USB_Notification_Header_t rq;
+	uint8_t n, r;
+
+	batchReplyLen = 0;
+	while (len >= 5)
+	{
+		rq.bRequest = data[0];
+		n = data[1];
+		rq.wValue.w = data[2] | (data[3] << 8);
+		rq.wIndex.w = data[4];
+		data += 5;
+		len -= 5;
+
+		if ((n > len) || (rq.bRequest == 0x38))	// Malformed, or a batch within a batch
+			break;
+
+		// Host to Device command, executed in order (not queued) with the other sub-commands
+		if (((rq.bRequest & 0xf0) == 0x30) || USB_CMD_OUT_4X(rq.bRequest))
+			usbFunctionWrite(&rq, data, n);
+		else									// Query command, add its result to batchReply
+		{
+			r = usbFunctionSetup(&rq);
+			if (batchReplyLen + 1 + r > sizeof(batchReply))
+				break;
+			batchReply[batchReplyLen++] = r;
+			memcpy(&batchReply[batchReplyLen], usbMsgPtr, r);
+			batchReplyLen += r;
+		}
+		data += n;
+		len -= n;
+	}
+}
+#endif
+
+
+
+#if CW_KEY_EVENTS								// Timestamped CW key and PTT edges, USB Cmd 0x52
+//
+//-----------------------------------------------------------------------------------------
+//			Queue CW key and PTT edges
+//
+//			Called from the pin change interrupt, and with interrupts disabled from
+//			the mainloop.  The first edge on a key input is queued at once, further
+//			edges within CW_DEBOUNCE are contact bounce.  The mainloop call picks up
+//			the level a key settles at after the bounce, and PTT (TX_FLAG) changes
+//-----------------------------------------------------------------------------------------
+//
+void cw_edge(uint16_t now)
+{
+	uint8_t state = cw_state;
+	uint8_t pins = 0;
+	uint8_t next;
+
+	if (IO_PIN_PTT_CWKEY & IO_CWKEY1) pins |= REG_CWSHORT;
+	if (IO_PIN_PTT_CWKEY & IO_CWKEY2) pins |= REG_CWLONG;
+	if (Status1 & TX_FLAG) pins |= REG_TX_state;
+	#if CW_KEYER
+	if (keyer_key) pins |= REG_KEY_DOWN;
+	#endif
+
+	if (((pins ^ state) & REG_CWSHORT) && ((uint16_t)(now - cw_time[0]) >= CW_DEBOUNCE))
+	{
+		state ^= REG_CWSHORT;
+		cw_time[0] = now;
+	}
+	if (((pins ^ state) & REG_CWLONG) && ((uint16_t)(now - cw_time[1]) >= CW_DEBOUNCE))
+	{
+		state ^= REG_CWLONG;
+		cw_time[1] = now;
+	}
+	#if CW_KEYER
+	state = (state & ~(REG_TX_state | REG_KEY_DOWN)) | (pins & (REG_TX_state | REG_KEY_DOWN));
+	#else
+	state = (state & ~REG_TX_state) | (pins & REG_TX_state);
+	#endif
+
+	if (state == cw_state) return;				// No change, or contact bounce
+	cw_state = state;
+
+	next = (cw_in + 1) & (CW_EVENTS_LEN - 1);
+	if (next == cw_out)							// Queue full, lose the newest edge
+	{
+		cw_overflow = True;
+		return;
+	}
+	cw_events[cw_in].time = now;
+	cw_events[cw_in].state = state;
+	cw_in = next;
+}
+
+ISR(CW_SIGNAL)
+{
+	cw_edge(TCNT1);
+}
+#endif
+
+
+#if USB_TELEMETRY								// Interrupt IN endpoint telemetry stream
+//
+//-----------------------------------------------------------------------------------------
+//			Refresh the telemetry record, sent by USB-EP0.c when the host polls for it
+//-----------------------------------------------------------------------------------------
+//
+static void telemetry_update(void)
+{
+	telemetry.seq++;
+	telemetry.status1 = Status1;
+	telemetry.status2 = Status2;
+	telemetry.freq = R.Freq[0];
+	memcpy(telemetry.adc, ad7991_adc, sizeof(telemetry.adc));
+	telemetry.tmp = tmp100_data;
+	telemetry.swr = measured_SWR;
+	#if USB_HOP_LIST							// Firmware timed frequency hop list
+	telemetry.hop_count = hop_count;			// Lets the host see hops for which the record
+	telemetry.hop_entry = hop_entry;			// was replaced before it was picked up
+	#endif
+	telemetry_ready = True;
+}
+#endif
+
 
 //
 //-----------------------------------------------------------------------------------------
@@ -1383,6 +2202,136 @@ void maintask(void)
 		#if ENCODER_SCAN_STYLE						// Shaft Encoder which scans the GPIO inputs
 		encoder_scan();								// Scan the Shaft Encoder
 		#endif
+		#if ENCODER_INT_STYLE						// Interrupt driven Shaft Encoder
+		encoder_update();							// Apply ticks gathered by the interrupt handler
+		#endif
+
+		#if ENCODER_INT_STYLE && ENCODER_FAST_RETUNE// Write encoder frequency changes without delay
+		//
+		// Enact (write) frequency changes on the next pass through the mainloop,
+		// but not more often than once per ENC_RETUNE_MIN
+		//
+		static uint16_t	retune_last;				// Time of last write to the Si570
+
+		#if SWR_SWEEP								// The SWR sweep owns the frequency, drop
+		if (sweep_state >= SWEEP_TUNE)				// changes by the Encoder or USB commands
+			Status2 &= ~ENC_NEWFREQ;
+		#endif
+
+		if ((Status2 & ENC_NEWFREQ) && ((uint16_t)(TCNT1 - retune_last) >= ENC_RETUNE_MIN))
+		{
+			R.Freq[R.SwitchFreq] = R.Freq[0];		// Keep track, move into short term memory
+			SetFreq(R.Freq[0]);						// Write the new frequency to Si570
+			encoder_retuned();						// Measure latency since the encoder pulse
+			retune_last = TCNT1;
+			Status2 &= ~ENC_NEWFREQ;				// and clear flag
+			pushcount = 0;							// Clear the push counter for next time
+
+			#if LCD_PAR_DISPLAY2
+			lcd_display_freq_and_filters();			// Display frequency and filters
+			#endif
+		}
+		#endif
+
+		#if USB_TIMED_FREQ							// Frequency change on a given USB frame, Cmd 0x48
+		//
+		// Write the frequency once the USB frame number has reached the target frame
+		// (within the next 1024 frames).  The frame number is polled here rather than
+		// acting on the SOF interrupt, as the Si570 is not written from interrupt context.
+		// The frame number in which the write is completed is recorded for Cmd 0x49
+		//
+		#if SWR_SWEEP								// The SWR sweep owns the frequency, drop
+		if (sweep_state >= SWEEP_TUNE)				// a pending change, as for the Encoder
+			timed_pending = False;
+		#endif
+
+		if (timed_pending && !((UDFNUM - timed_frame) & 0x400))
+		{
+			R.Freq[0] = timed_freq;
+			R.Freq[R.SwitchFreq] = R.Freq[0];		// Keep track, move into short term memory
+			SetFreq(R.Freq[0]);						// Write the new frequency to Si570
+			timed_applied = UDFNUM & 0x7ff;
+			timed_pending = False;
+
+			#if LCD_PAR_DISPLAY2
+			lcd_display_freq_and_filters();			// Display frequency and filters
+			#endif
+		}
+		#endif
+
+		#if CW_KEY_EVENTS							// Timestamped CW key and PTT edges
+		cli();
+		cw_edge(TCNT1);								// Key levels after contact bounce, and PTT
+		sei();
+		#endif
+
+		#if CW_KEYER								// Iambic keyer
+		keyer_ptt_update();							// Key or release PTT, as set by the keyer
+		#endif
+
+		#if POWER_SWR && SWR_ALARM_FUNC && SWR_FAST_TRIP// Fast SWR trip, USB Cmd 0x56
+		SWR_fast_trip();							// Sample and compare every 2.5ms during TX
+		#endif
+
+		#if SWR_SWEEP								// SWR sweep, started by USB Cmd 0x4c
+		SWR_sweep();								// Retune, key or measure the next point
+		#endif
+
+		#if USB_HOP_LIST							// Firmware timed frequency hop list
+		//
+		// Step to the next entry when the dwell time of the current one has passed.
+		// The dwell time is counted from when the previous hop was due, rather than
+		// from when it was done, so that the hop rate does not drift.  Held while an
+		// SWR sweep is running
+		//
+		static uint16_t	hop_last;					// TCNT1 at the last pass
+		static uint32_t	hop_elapsed;				// TCNT1 ticks in the current entry
+
+		#if SWR_SWEEP								// SWR sweep, started by USB Cmd 0x4c
+		if (hop_mode && (sweep_state < SWEEP_TUNE))
+		#else
+		if (hop_mode)
+		#endif
+		{
+			uint32_t dwell = 0;						// Dwell time of the current entry (1/62500 s)
+
+			if (hop_entry == 0xff)					// Just started by Cmd 0x4b
+				hop_elapsed = 0;
+			else
+				dwell = hop_list[hop_entry].dwell * 125UL / 2;
+
+			hop_elapsed += (uint16_t)(TCNT1 - hop_last);
+			if (hop_elapsed >= dwell)
+			{
+				hop_elapsed -= dwell;
+				if (hop_elapsed >= dwell)			// More than a dwell time behind, resync
+					hop_elapsed = 0;
+
+				if (++hop_entry >= hop_len)			// (0xff wraps to entry 0 at start)
+				{
+					hop_entry = 0;
+					if (!(hop_mode & HOP_REPEAT))	// Done, stay on the last entry
+					{
+						hop_mode = 0;
+						hop_entry = hop_len - 1;
+					}
+				}
+
+				if (hop_mode)
+				{
+					R.Freq[0] = hop_list[hop_entry].freq;
+					SetFreq(R.Freq[0]);				// Write the new frequency to Si570
+					hop_count++;
+
+					#if USB_TELEMETRY				// Interrupt IN endpoint telemetry stream
+					if (hop_mode & HOP_NOTIFY)		// Send a record with the new frequency
+						telemetry_update();
+					#endif
+				}
+			}
+		}
+		hop_last = TCNT1;
+		#endif
 
 		#if FAST_LOOP_THRU_LED1						// Blink PB2 LED every time when going through the mainloop 
 		PORTB = PORTB ^ IO_LED1;  					// Blink a led
@@ -1415,10 +2364,32 @@ void maintask(void)
 		}
 		onoff++;
 		#endif
-		
+
+		#if USB_DEFERRED_CMD						// Defer USB triggered EEPROM writes and I2C traffic
+		usbCmdFlush();								// Execute queued USB commands (always before REBOOT)
+		#endif
+
+		#if USB_CONFIG_IMAGE						// Dump and restore the EEPROM settings image
+		configCommit();								// Rewrite the EEPROM after a failed restore
+		while ((Status1 & REBOOT) && config_commit)	// and finish it before a REBOOT
+		{
+			configCommit();
+			wdt_reset();
+		}
+		#endif
+
 		while (Status1 & REBOOT);					// If REBOOT flag is set, then get
 													// stuck here, and reboot by watchdog
 	}
+
+	#if TR_SEQUENCER								// T/R sequencer, USB Cmds 0x54 and 0x55
+	//
+	// Do the T/R sequence steps which are due.  While a sequence is in progress, the
+	// LCD is not updated, so that it does not delay the steps.  The temperature and
+	// SWR protections below, and the ADC polls they depend on, keep running
+	//
+	uint8_t tr_busy = tr_sequence();
+	#endif
 	
 	//-------------------------------------------------------------------------------
 	// Here we do routines which are to be accessed once every ~second or less
@@ -1435,6 +2406,9 @@ void maintask(void)
 			ad7991_poll(R.AD7991_I2C_addr);			// Polls the AD7991 every time (9 bytes)
 													// => constant traffic on I2C
 			#if LCD_PAR_DISPLAY2
+			#if TR_SEQUENCER						// Not while a T/R sequence is in progress
+			if (!tr_busy)
+			#endif
 			lcd_display_P_SWR_V_C_T();				// Display non-static measured values
 			#endif
 		}
@@ -1454,6 +2428,9 @@ void maintask(void)
 				ad7991_poll(R.AD7991_I2C_addr);		// Polls the AD7991 every time (9 bytes)
 													// => constant traffic on I2C
 				#if LCD_PAR_DISPLAY2
+				#if TR_SEQUENCER					// Not while a T/R sequence is in progress
+				if (!tr_busy)
+				#endif
 				lcd_display_P_SWR_V_C_T();			// Display non-static measured values
 				#endif
 			}
@@ -1559,6 +2536,10 @@ void maintask(void)
 		#endif
 
 
+		#if BARGRAPH && BARGRAPH_FAST && (LCD_PAR_DISPLAY || LCD_PAR_DISPLAY2 || LCD_I2C_DISPLAY)
+		lcd_bargraph_frame();						// New display pass, before any bargraph is drawn
+		#endif
+
 		#if ENCODER_INT_STYLE || ENCODER_SCAN_STYLE	// Shaft Encoder VFO function
 		#if ENCODER_FAST_ENABLE						// Variable speed Rotary Encoder feature
 		//
@@ -1568,7 +2549,11 @@ void maintask(void)
 
 		if (Status2 & ENC_FAST)						// Is fast mode active?
 		{
+			#if ENCODER_INT_STYLE && ENCODER_FAST_RETUNE// ENC_NEWFREQ is cleared on the next mainloop pass
+			if (Status2 & ENC_CHANGE)				// Encoder activity, reset timer
+			#else
 			if (Status2 & ENC_NEWFREQ)				// Encoder activity, reset timer
+			#endif
 				fast_patience=0;
 			else									// No activity, increase timer
 				fast_patience++;
@@ -1579,6 +2564,9 @@ void maintask(void)
 				fast_patience = 0;
 			}
 		}
+		#if ENCODER_INT_STYLE && ENCODER_FAST_RETUNE
+		Status2 &= ~ENC_CHANGE;						// Clear activity flag
+		#endif
 		#endif
 		//
 		// Read Pushbutton state from Shaft encoder and manage Frequency band memories
@@ -1597,17 +2585,11 @@ void maintask(void)
 		{
 			if (pushcount >= ENC_PUSHB_MIN)			// Release after a "Short push"
 			{	
-				#if ENCODER_INT_STYLE				// Interrupt driven Shaft Encoder
-				cli();								// Don't want a rogue interrupt to mess with us
-				#endif
 				R.SwitchFreq++;						// rotate through memories
 				if (R.SwitchFreq > 9) R.SwitchFreq = 1;
 				R.Freq[0] = R.Freq[R.SwitchFreq];	// Fetch last stored frequency in next band
 				Status2 |= ENC_NEWFREQ;				// Signal a new frequency to be written
 													// to the Si570 device
-				#if ENCODER_INT_STYLE				// Interrupt driven Shaft Encoder
-				sei();
-				#endif
 			}
 			else
 			{										// No push or a very short push, do nothing
@@ -1631,13 +2613,21 @@ void maintask(void)
 		//
 		// Print to LCD Display
 		//
+		#if TR_SEQUENCER							// Not while a T/R sequence is in progress
+		if (!tr_busy)
+		#endif
 		lcd_display();
 		
 		#elif LCD_PAR_DISPLAY2
-		lcd_display_TRX_status_on_change();			// Display TX/RX transition stuff
-		if (Status1 & TX_FLAG)
+		#if TR_SEQUENCER							// Not while a T/R sequence is in progress
+		if (!tr_busy)
+		#endif
 		{
-			lcd_display_P_SWR_V_C_T();				// Display non-static measured values
+			lcd_display_TRX_status_on_change();		// Display TX/RX transition stuff
+			if (Status1 & TX_FLAG)
+			{
+				lcd_display_P_SWR_V_C_T();			// Display non-static measured values
+			}
 		}
 		#endif
 	}
@@ -1682,6 +2672,11 @@ void maintask(void)
 		//
 		// Update all ADC readings
 		//
+		#if POWER_SWR && SWR_ALARM_FUNC && SWR_FAST_TRIP// The fast SWR trip has polled during TX,
+		if (swr_trip_polled)						// use its latest readings
+			swr_trip_polled = 0;
+		else
+		#endif
 		// I2C noise reduction, less or no I2C traffic during RX
 		#if SSLO_POLL_DURING_RX ||	SLOW_POLL_DURING_RX	|| NO_I2C_DURING_RX
 		if (Status1 & TX_FLAG)
@@ -1696,6 +2691,9 @@ void maintask(void)
 													// autobias measurement
 
 		#if	POWER_SWR								// Power/SWR measurements and related actions
+		#if PWR_CAL_TABLE							// Power calibration table
+		pwr_cal_update();							// Select the band table of the TX filter in use
+		#endif
 		//
 		// SWR Protect
 		//
@@ -1709,29 +2707,80 @@ void maintask(void)
 													// => constant traffic on I2C (can be improved to slightly
 		#endif										// reduce I2C traffic, at the cost of a few extra bytes)
 
+		#if POWER_SWR && PEP_METER					// PEP, average and peak hold, USB Cmd 0x57
+		pep_update();								// Add the new forward power reading
+		#endif
+
+		#if !(ENCODER_INT_STYLE && ENCODER_FAST_RETUNE)// Else written on the next mainloop pass
 		//
 		// Enact (write) frequency changes resulting from interrupt routine or
 		// from the pushbutton memory management routine above
 		//
+		#if SWR_SWEEP								// The SWR sweep owns the frequency, drop
+		if (sweep_state >= SWEEP_TUNE)				// changes by the Encoder or USB commands
+			Status2 &= ~ENC_NEWFREQ;
+		#endif
+
 		if (Status2 & ENC_NEWFREQ)					// VFO was turned or freq updated above
 		{
-			#if ENCODER_INT_STYLE					// Interrupt driven Shaft Encoder
-			cli();									// Don't want a rogue interrupt to mess with us
-			#endif
 			R.Freq[R.SwitchFreq] = R.Freq[0];		// Keep track, move into short term memory
 			SetFreq(R.Freq[0]);						// Write the new frequency to Si570
 			Status2 &= ~ENC_NEWFREQ;				// and clear flag
 			pushcount = 0;							// Clear the push counter for next time
-			#if ENCODER_INT_STYLE					// Interrupt driven Shaft Encoder
-			sei();
-			#endif
 
 			#if LCD_PAR_DISPLAY2
 			lcd_display_freq_and_filters();			// Display frequency and filters
 			#endif
 		}
+		#endif
+
+		#if USB_SNAPSHOT_CMD						// Consistent measurement snapshot, USB Cmd 0x62
+		//
+		// Fill in a new snapshot of the measurements in the inactive buffer, then
+		// swap buffers.  A snapshot being returned by Cmd 0x62 is never modified
+		//
+		{
+			snapshot_t *snap = &snapshot[snapshot_active ^ 1];
+
+			snap->seq = snapshot[snapshot_active].seq + 1;
+			snap->status1 = Status1;
+			snap->status2 = Status2;
+			snap->freq = R.Freq[0];
+			memcpy(snap->adc, ad7991_adc, sizeof(snap->adc));
+			snap->tmp = tmp100_data;
+			snap->swr = measured_SWR;
+			#if	POWER_SWR								// Power/SWR measurements and related actions
+			snap->pwr_out = measured_Power(ad7991_adc[AD7991_POWER_OUT].w);
+			snap->pwr_ref = measured_Power(ad7991_adc[AD7991_POWER_REF].w);
+			#endif
+			snap->filters[0] = selectedFilters[0];
+			snap->filters[1] = selectedFilters[1];
+
+			snapshot_active ^= 1;
+		}
+		#endif
+
+		#if USB_TELEMETRY							// Interrupt IN endpoint telemetry stream
+		//
+		// Refresh the telemetry record, sent by USB-EP0.c when the host polls for it
+		//
+		static uint8_t telemetry_count;				// Telemetry interval counter
+
+		if (++telemetry_count >= telemetry_period[(Status1 & TX_FLAG) ? 1 : 0])
+		{
+			telemetry_count = 0;
+			telemetry_update();
+		}
+		#endif
 	}
 
+	#if ((LCD_PAR_DISPLAY || LCD_PAR_DISPLAY2) && LCD_FRAMEBUFFER) || (LCD_I2C_DISPLAY && LCD_I2C_BATCH)
+	#if TR_SEQUENCER								// Not while a T/R sequence is in progress
+	if (!tr_busy)
+	#endif
+	lcd_flush();									// Send the LCD characters which have changed
+	#endif
+
 	wdt_reset();									// Whoops... must remember to reset that running watchdog
 }
 
@@ -1763,6 +2812,14 @@ int main(void)
 	IO_DDR_PTT_CWKEY = IO_LED1 | IO_LED2 | IO_PTT;	// Set pins for output
 	IO_PORT_PTT_CWKEY = IO_CWKEY1 | IO_CWKEY2;		// Set pullups for CW key input pins
 
+	#if CW_KEY_EVENTS								// Timestamped CW key and PTT edges
+	CW_PCMSK |= CW_PCINT;							// Pin change interrupt on the CW key inputs
+	PCICR |= CW_PCIE;
+	if (IO_PIN_PTT_CWKEY & IO_CWKEY1) cw_state |= REG_CWSHORT;// Start from the current key levels
+	if (IO_PIN_PTT_CWKEY & IO_CWKEY2) cw_state |= REG_CWLONG;
+	sei();
+	#endif
+
 	#if	FAN_CONTROL									// Turn PA Cooling FAN On/Off, based on temperature
 	#if	PORTD_FAN
 	IO_DDR_FC = IO_DDR_FC | IO_FC;  				// Set FAN_CONTROL Pin as output
@@ -1792,6 +2849,10 @@ int main(void)
 		eeprom_read_block(&R, &E, sizeof(E));		// Load the persistent data from eeprom
 	}
 
+	#if POWER_SWR && (FAST_METERING || SWR_FAST_TRIP)// Precalculated metering constants
+	meter_update();									// Work out the metering constants
+	#endif
+
 	//#if USB_SERIAL_ID								// A feature to change the last char of the USB Serial  number
 	// Modify the last byte of the USB descriptor Serial number ("TF3LJ-1.X")
 	// This function would need some means to only modify one byte in FLASH ROM,
@@ -1847,6 +2908,10 @@ int main(void)
 	shaftEncoderInit();								// Init shaft encoder
 	#endif
 
+	#if CW_KEYER									// Iambic keyer
+	keyerInit();									// Start the 1ms keyer interrupt
+	#endif
+
 	Initialize_USB();								// Start the works, we're in business
 }
 
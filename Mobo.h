@@ -115,6 +115,7 @@
 #include <avr/interrupt.h>
 #include <avr/pgmspace.h>
 #include <util/delay.h>
+#include <util/crc16.h>
 #include <avr/power.h>
 #include "AVRLIB/rprintf.h"							// AVRLIB (not AVRLibc) functions
 
@@ -357,6 +358,10 @@
 #define ENCODER_INT_STYLE	0	// Interrupt driven Rotary Encoder VFO, uses one interrupt, gives
 								// only half the resolution of the encoder (every other click inactive)
 								//(Cost 652 bytes)
+#define ENCODER_INT_TABLE	0	// Used with ENCODER_INT_STYLE.  Interrupt on both phases (INT6 on Phase A,
+								// pin change interrupt PCINT12 on Phase B) with a table driven decoder.
+								// Gives full resolution of the encoder. Invalid transitions are counted
+								// and can be read through USB Cmd 0x69
 
 // It makes little sense to have both of the two below enabled at the same time.
 #define ENCODER_CMD_INCR	0	// USB Cmd 0x36. Modify Encoder Resolution, 32 bit signed integer.
@@ -369,6 +374,102 @@
 #define ENCODER_DIR_SENSE	1	// Direction change sense.  Used with variable speed feature.
 								// Direction change drops immediately out of fast speed mode
 								// (cost 42 bytes)
+#define ENCODER_ACCEL	0	// Used with ENCODER_INT_STYLE.  Velocity based acceleration curve, the step
+								// size follows the encoder speed, measured between encoder pulses.
+								// Replaces ENCODER_FAST_ENABLE.  Curve is read/modified with USB Cmd 0x6a
+#define ENCODER_FAST_RETUNE	0	// Used with ENCODER_INT_STYLE.  Write encoder frequency changes to the Si570
+								// on the next mainloop pass rather than in the 10ms slot, at most once
+								// per ENC_RETUNE_MIN.  Retune latency can be read through USB Cmd 0x69
+
+//-----------------------------------------------------------------------------
+// USB command handling
+//
+#define USB_DEFERRED_CMD	0	// Defer EEPROM writes and I2C traffic caused by USB commands to the
+								// mainloop.  The USB control request is answered immediately, using
+								// cached values where possible (Cmd 0x3f returns the Si570 registers
+								// last written, rather than reading them back from the chip)
+								// (Uses 32 bytes of RAM for the command queue)
+
+#define USB_TELEMETRY	0	// Interrupt IN endpoint (EP1) streaming a telemetry record with the ADC
+								// inputs, temperature, SWR, status flags and frequency.  Interval set
+								// with USB Cmd 0x63, default 100ms during RX and 10ms during TX
+
+#define USB_SNAPSHOT_CMD	0	// USB Cmd 0x62.  Read a consistent snapshot of all ADC inputs, temperature,
+								// SWR, power, selected filters and status flags in a single transfer.
+								// Double buffered, updated every 10ms (Uses 52 bytes of RAM)
+
+#define USB_CONFIG_IMAGE	0	// USB Cmd 0x37, 0x44 and 0x45.  Dump and restore the whole EEPROM settings
+								// image in chunks, with a CRC check before a restored image is used
+
+#define USB_BATCH_CMD		0	// USB Cmd 0x38 and 0x46.  Execute a batch of sub-commands (e.g. set frequency,
+								// set PTT and read the CW key state) in a single OUT transfer of up to
+								// 24 bytes, the concatenated results are read back with Cmd 0x46
+								// (Uses 33 bytes of RAM)
+
+#define USB_TIMED_FREQ		0	// USB Cmd 0x48 and 0x49.  Write a new frequency to the Si570 when the USB
+								// frame number reaches a given value, and report the frame number
+								// in which it was written, for retunes aligned with the audio stream
+
+#define USB_HOP_LIST		0	// USB Cmd 0x4a and 0x4b.  Step through a list of up to HOP_LIST_LEN frequencies,
+								// each with its own dwell time in ms, timed by the firmware rather
+								// than by the host (Uses 60 bytes of RAM)
+
+#define SWR_SWEEP		0	// USB Cmd 0x4c, 0x4d and 0x4e.  SWR sweep, the firmware steps through a range
+								// of frequencies with the transmitter keyed, measuring SWR at each
+								// point.  Used with POWER_SWR (Uses 120 bytes of RAM)
+
+#define CW_KEY_EVENTS		0	// USB Cmd 0x52.  Pin change interrupt on the CW key inputs.  Debounced CW key
+								// and PTT edges are timestamped and queued, to be read with Cmd 0x52
+								// rather than polling Cmd 0x51 (Uses 56 bytes of RAM)
+
+#define CW_KEYER		0	// USB Cmd 0x53.  Iambic A/B keyer, timed by a 1ms Timer1 compare interrupt.
+								// Paddles on the CW key inputs, PTT through the Mobo PCF or IO_PTT.
+								// Key down is reported in Cmd 0x51 bit 7 (and Cmd 0x52 edges)
+
+#define TR_SEQUENCER		0	// USB Cmd 0x54 and 0x55.  T/R sequencer, PTT from Cmd 0x50 (and the keyer)
+								// switches RX mute, antenna relay, PTT, bias and PTT2 in order, with a
+								// configurable delay before each step, and the reverse for RX
+
+#define FAST_METERING		0	// Power, voltage and current readings by multiply and shift, with constants
+								// worked out when the calibration values are changed, rather than
+								// by divisions on every reading
+
+#define SWR_FAST_TRIP		0	// USB Cmd 0x56.  Fast SWR trip, used with SWR_ALARM_FUNC.  During TX, the
+								// AD7991 is polled every 2.5ms, and PTT2 and the bias fallback are set
+								// after a configurable number of samples over the SWR threshold
+
+#define PEP_METER		0	// USB Cmd 0x57.  PEP, average and peak hold power metering, used with POWER_SWR.
+								// Updated on every 10ms AD7991 reading, at a constant cost per sample, and
+								// also used by the LCD PEP indication (PWR_PEAK_ENVELOPE)
+
+#define BIAS_FAST_CAL		0	// USB Cmd 0x58.  PA bias calibration by successive approximation, both bias
+								// settings are found in ~16 steps, with a settle time before each reading,
+								// rather than by stepping the bias DAC up one count every 10ms
+
+#define ADC_DECIMATE		0	// USB Cmd 0x59.  Accumulate and dump (boxcar) filter of the AD7991 readings,
+								// 1 - 16 readings per channel are summed into each value of ad7991_adc[],
+								// which then carries up to 16 bits instead of 12
+
+#define PWR_CAL_TABLE		0	// USB Cmds 0x4f, 0x5a and 0x5b.  Power meter calibration table, used with
+								// POWER_SWR.  Up to 16 (AD reading, mW) points for each of 4 bands, loaded
+								// by the host and interpolated, with a 32 bit power reading
+								// (Uses 96 bytes of RAM for the band table in use)
+
+#define LCD_FRAMEBUFFER		0	// Parallel LCD frame buffer.  The display routines write into a RAM image of the
+								// display, and only the characters which have changed are sent to the LCD,
+								// once per pass of maintask().  Costs ~100 bytes of RAM with a 20x4 display
+
+#define LCD_BACKGROUND		0	// Used with LCD_FRAMEBUFFER.  The frame buffer is sent to the LCD one character
+								// or command per pass of maintask(), when the LCD is not busy, rather than by
+								// waiting on the LCD busy flag.  Changes are sent within LCD_FLUSH_DEADLINE
+
+#define LCD_I2C_BATCH		0	// Used with LCD_I2C_DISPLAY.  Characters and cursor commands for the I2C LCD are
+								// collected, and sent as one I2C transaction at the end of each pass of
+								// maintask(), rather than one transaction for each character
+
+#define BARGRAPH_FAST		0	// LCD bargraphs drawn by changes.  The pixel scale is worked out when the
+								// full scale is changed, rather than by a 32 bit division on each reading,
+								// and only the bargraph characters which have changed are written
 
 //-----------------------------------------------------------------------------
 // Debug stuff, do not use
@@ -433,6 +534,14 @@
 #define	BIAS_HI				35		// PA Bias in 10 * mA, Class A  (35 = 350mA)
 #define	CAL_LO				0		// PA Bias setting, Class B
 #define	CAL_HI				0		// PA Bias setting, Class A
+#if BIAS_FAST_CAL					// Fast PA bias calibration, USB Cmd 0x58
+#define	BIAS_SETTLE			2		// Settle time before each bias reading, in 10ms
+// Calibration status, returned by USB Cmd 0x58
+#define	BIAS_CAL_IDLE		0		// Not run since power up
+#define	BIAS_CAL_RUN		1		// Calibration in progress
+#define	BIAS_CAL_DONE		2		// Both bias settings found
+#define	BIAS_CAL_FAILED		3		// Bias current not reached, both settings set to 0
+#endif
 
 
 
@@ -447,6 +556,20 @@
 #define PEP_PERIOD			10				// Time period for PEP measurement (in 100ms)
 											// PEP_PERIOD is used with PWR_PEAK_ENVELOPE func
 											// under LCD display.
+#if PEP_METER								// PEP, average and peak hold, USB Cmd 0x57
+#define PEP_BUCKET			10				// AD7991 readings in each 100ms of the PEP window
+#define PEP_AVG_SHIFT		5				// Average over ~2^5 readings (320ms)
+#endif
+#if PWR_CAL_TABLE							// Power calibration table, USB Cmds 0x4f, 0x5a, 0x5b
+#define PWR_CAL_BANDS		4				// Band tables, selected by the TX filter in use
+#define PWR_CAL_POINTS		16				// Max points in a band table
+#define PWR_CAL_DEFAULTS	{ 0, 0, 0, 0 }	// No band tables loaded, the formula is used
+#endif
+#if SWR_FAST_TRIP							// Fast SWR trip, USB Cmd 0x56
+#define SWR_TRIP_PERIOD		156				// AD7991 sample period during TX (1/62500 s, 2.5ms),
+											// a poll takes 200-500us of bit banged I2C
+#define SWR_TRIP_COUNT		2				// Samples in a row over the SWR threshold to trip
+#endif
 
 
 // These two are only used if BARGRAPH is defined:
@@ -456,6 +579,11 @@
 #else
 #define SWR_FULL_SCALE		400				// Bargraph SWR fullscale: Max SWR = Value/100 + 1 (400 = 5.0:1)
 #endif
+#if BARGRAPH_FAST							// Bargraphs drawn by changes
+#define BAR_PWR				0				// Power Output Bargraph
+#define BAR_SWR				1				// SWR Bargraph
+#define BARGRAPH_BARS		2
+#endif
 
 
 
@@ -489,6 +617,56 @@
 //#define REG_PTT_2			(1 << 3)		// Used with SDR-Widget, not Mobo - so far
 //#define REG_PTT_3			(1 << 4)		// Used with SDR-Widget, not Mobo - so far
 #define REG_TX_state		(1 << 6)		// Indicate transmit status
+#if CW_KEYER
+#define REG_KEY_DOWN		(1 << 7)		// Key down, as sent by the on-device keyer
+#endif
+
+#if CW_KEY_EVENTS							// Timestamped CW key and PTT edges, USB Cmd 0x52
+// Pin change interrupt on the CW key inputs, PCINT0-7->PB0-PB7 (PCINT0_vect)
+#define CW_SIGNAL			PCINT0_vect		// Pin change interrupt signal name
+#define CW_PCMSK			PCMSK0			// Pin change mask register
+#define CW_PCINT			((1 << PCINT0) | (1 << PCINT1))// matching IO_CWKEY1 and IO_CWKEY2
+#define CW_PCIE				(1 << PCIE0)	// matching PCIEx bit in PCICR
+#define CW_EVENTS_LEN		16				// Number of queued edges, must be a power of 2
+#define CW_DEBOUNCE			63				// Edges on a key input are ignored for 1ms (in
+											// units of 1/62500 s) after an accepted edge
+#endif
+
+#if CW_KEYER								// Iambic keyer, USB Cmd 0x53
+// Keyer parameters, R.Keyer[] and E.Keyer[], read and modified with USB Cmd 0x53
+#define KEYER_MODE			0				// Index of the mode bits, see below
+#define KEYER_WPM			1				// Index of the speed in Words Per Minute (5 - 60)
+#define KEYER_WEIGHT		2				// Index of the weight in percent, 50 = 1:1 (25 - 75)
+#define KEYER_HANG			3				// Index of the PTT hang time, in units of 10ms
+#define KEYER_PARAMS		4				// Number of keyer parameters
+#define KEYER_DEFAULTS		{ 0, 20, 50, 0 }// Mode (off), WPM, weight and hang time
+// Mode bits
+#define KEYER_ON			0x01			// Keyer enabled
+#define KEYER_IAMBIC_B		0x02			// Iambic mode B, else mode A
+#define KEYER_SWAP			0x80			// Swap the dit and dah paddles
+// Timer1 runs at 62500 Hz, the keyer is clocked by a compare interrupt every 62.5 ticks
+#define KEYER_TICK			62				// Timer1 ticks per ms, the half tick is added
+											// on every other interrupt
+#endif
+
+#if TR_SEQUENCER							// T/R sequencer, USB Cmds 0x54 and 0x55
+// Steps of the T/R sequence, in the order done for TX.  RX is done in the reverse order
+#define TR_MUTE				0				// RX mute, R.TR_Seq[TR_MUTE_BITS] on the Mobo PCF8574
+#define TR_ANT				1				// Antenna relay, R.TR_Seq[TR_ANT_BITS] on the Mobo PCF8574
+#define TR_PTT				2				// PTT, Mobo_PCF_TX or IO_PTT
+#define TR_BIAS				3				// PA bias, set by PA_bias() (TX only)
+#define TR_PTT2				4				// SWR protect secondary PTT, Mobo_PCF_TX2
+#define TR_STEPS			5				// Number of steps
+// Sequencer parameters, R.TR_Seq[] and E.TR_Seq[], read and modified with USB Cmd 0x54
+// 0 - 4 = delay in ms before each TX step, 5 - 9 = delay in ms before each RX step
+#define TR_RX_DELAY			TR_STEPS		// Index of the first RX delay
+#define TR_MUTE_BITS		(2*TR_STEPS)	// Index of the RX mute bits, active low during TX
+#define TR_ANT_BITS			(2*TR_STEPS+1)	// Index of the antenna relay bits, active low during TX
+#define TR_PARAMS			(2*TR_STEPS+2)	// Number of sequencer parameters
+#define TR_DEFAULTS			{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }// No delays, no mute or relay bits
+#define TR_DELAY_MAX		200				// Max delay of a step in ms, so that a whole
+											// sequence can be timed with Timer1 (1.05 s)
+#endif
 
 
 
@@ -635,6 +813,16 @@
 #define AD7991_POWER_OUT	1
 #define AD7991_POWER_REF	2
 #define AD7991_PSU_VOLTAGE	3
+#if ADC_DECIMATE							// AD7991 decimation filter, USB Cmd 0x59
+// Decimation per channel, R.ADC_Decimate[], 2^n readings are summed into each value
+#define ADC_DECIMATE_MAX	4				// Max n, 16 x 12 bits fill the 16 bits of ad7991_adc[]
+#define ADC_DECIMATE_DEFAULTS	{ 0, 2, 2, 2 }// PA current unfiltered, for the bias calibration,
+											// 4 readings per value on the others, 40ms
+#endif
+
+// Conversion of the AD7991 readings for display, AD7991_VOLT_X10() and AD7991_AMP_X100(),
+// and the FAST_METERING power arithmetic
+#include "Mobo_Metering.h"
 
 
 
@@ -677,6 +865,9 @@
 #define LCD_LINES			2			// number of visible lines of the display 
 #define LCD_DISP_LENGTH		40			// visibles characters per line of the display
 #endif
+#if LCD_BACKGROUND							// LCD frame buffer sent in the background
+#define LCD_FLUSH_DEADLINE	50				// ms, older changes are sent at once, waiting on the LCD
+#endif
 
 // DEFS for I2C connected LCD display (very experimental!!!)
 #if 	LCD_I2C_DISPLAY					// 16x2 I2C connected LCD display... incomplete, test code
@@ -684,6 +875,10 @@
 										// which clashes with the AD7991-0 device.  This address
 										// can be changed manually.  However the command may confuse
 										// the AD7991 settings, so this should only be done once
+#if LCD_I2C_BATCH						// I2C LCD bytes sent in one transaction
+#define LCD_I2C_BUF			20			// Max bytes in one transaction, a line of characters
+										// and a cursor command
+#endif
 #endif
 
 
@@ -701,6 +896,16 @@
 #define ENC_A_INT		(1 << INT6)			// matching INTx bit in EIMSK
 #define ENC_A_ISCX0		(1 << ISC60)		// Interrupt Sense Config bit0 (ISCx0)
 #define ENC_A_ISCX1		(1 << ISC61)		// Interrupt Sense Config bit1 (ISCx1)
+#if ENCODER_INT_TABLE						// Interrupt on both phases, table driven decoder
+// Useable pin change interrupt pins on the AT90USB162:
+// PCINT0-7->PB0-PB7 (PCINT0_vect), PCINT8-12->PC6,PC5,PC4,PC2,PD5 (PCINT1_vect)
+// Phase B Pin Change Interrupt Configuration Parameters
+#define ENC_B_SIGNAL	PCINT1_vect			// Pin change interrupt signal name
+#define ENC_B_PCMSK		PCMSK1				// Pin change mask register
+#define ENC_B_PCINT		(1 << PCINT12)		// matching PCINTx bit in the mask register
+#define ENC_B_PCIE		(1 << PCIE1)		// matching PCIEx bit in PCICR
+#define ENC_INVALID		2					// Decoder table entry for an invalid transition
+#endif
 #endif
 #if ENCODER_INT_STYLE || ENCODER_SCAN_STYLE	// Common for both Interrupt and Scan style Encoder
 // Configuration of the two input pins, Phase A and Phase B
@@ -739,7 +944,7 @@
 // Definitions for Variable Speed Rotary Encoder function
 // The below parameters are hopefully more or less generic for any encoder, down to 32 pulses or so,
 // but are optimized for a 1024 state Rotary Encoder
-#define ENC_FAST_SENSE		96000/ENC_PULSES// Maximum time threshold (in steps of 1/65536 s) per click to enable fast mode
+#define ENC_FAST_SENSE		96000/ENC_PULSES// Maximum time threshold (in steps of 1/62500 s) per click to enable fast mode
 #define ENC_FAST_TRIG		ENC_PULSES/5	// Number of fast clicks to enable fast Mode
 											// Make sure this does not exceed uint8_t
 #define ENC_FAST_MULTIPLY	100				// Encoder click multiplier during FAST mode (max 128)
@@ -747,6 +952,71 @@
 											// normal encoder mode if no encoder activity
 #endif
 
+#if ENCODER_FAST_RETUNE						// Write encoder frequency changes without delay
+#define ENC_RETUNE_MIN		125				// Minimum time between writes to the Si570
+											// (in steps of 1/62500 s, 2ms)
+#endif
+
+#if ENCODER_ACCEL							// Velocity based acceleration curve
+// Definitions for the encoder acceleration curve
+// The curve is indexed by the number of significant bits in the time between encoder pulses
+// (in steps of 1/62500 s, 16us), fastest first.  Each point is the encoder click multiplier at
+// that speed.  Optimized for a 1024 state Rotary Encoder, can be modified with USB Cmd 0x6a
+#define ENC_ACCEL_STEPS		16				// Number of points in the acceleration curve
+#define ENC_ACCEL_IDLE		31250			// No pulse for this long is a pause, the next pulse
+											// is slow movement (in steps of 1/62500 s, 0.5s)
+#define ENC_ACCEL_CURVE		{ 200, 200, 200, 200, 120, 60, 25, 10, 4, 2, 1, 1, 1, 1, 1, 1 }
+#endif
+
+
+
+// DEFS for the deferred USB command queue
+#if USB_DEFERRED_CMD						// Defer USB triggered EEPROM writes and I2C traffic
+#define USB_CMDQ_LEN		4				// Number of queued commands.  If the queue is full,
+											// then the oldest command is executed immediately
+#define USBQ_EEPROM			0x00			// Queue entry is an EEPROM write (data -> addr)
+#define USBQ_PCF			0x01			// Queue entry is a byte write to a PCF8574 at addr
+#define USBQ_MOBO_PCF		0x02			// Queue entry refreshes the builtin Mobo PCF8574
+#endif
+
+// DEFS for the USB telemetry stream
+#if USB_TELEMETRY							// Interrupt IN endpoint telemetry stream
+#define TELEMETRY_EPNUM		1				// Endpoint number of the telemetry stream
+#define TELEMETRY_EPSIZE	32				// Endpoint size, a telemetry record has to fit
+#define TELEMETRY_RX		10				// Default interval during RX (x 10ms)
+#define TELEMETRY_TX		1				// Default interval during TX (x 10ms)
+#endif
+
+// DEFS for the USB batch command
+#if USB_BATCH_CMD							// Batch of sub-commands in one transfer
+#define BATCH_REPLY_SIZE	32				// Size of the buffer for the concatenated results
+#endif
+
+// DEFS for the frequency hop list
+#if USB_HOP_LIST							// Firmware timed frequency hop list
+#define HOP_LIST_LEN		8				// Number of entries in the hop list
+#define HOP_ONCE			0x01			// Cmd 0x4b Value: step through the list once
+#define HOP_REPEAT			0x02			// Cmd 0x4b Value: step through the list repeatedly
+#define HOP_NOTIFY			0x10			// Cmd 0x4b Value: send a telemetry record on each hop
+#endif
+
+// DEFS for the SWR sweep
+#if SWR_SWEEP								// SWR sweep, USB Cmds 0x4c - 0x4e
+#define SWEEP_POINTS		100				// Max number of points in a sweep
+#define SWEEP_IDLE			0				// sweep_state: Not running, or sweep completed
+#define SWEEP_ABORTED		1				// sweep_state: Ended by TMP_ALARM, SWR_ALARM or PTT release
+#define SWEEP_TUNE			2				// sweep_state: Retune to the next point
+#define SWEEP_SETTLE		3				// sweep_state: Keyed, waiting for the settle time
+#define SWEEP_STOP			4				// sweep_state: Stop requested by Cmd 0x4d
+#if !FRQ_CGH_DURING_TX						// The Si570 is retuned while the transmitter is keyed
+#error "SWR_SWEEP needs FRQ_CGH_DURING_TX"
+#endif
+#endif
+
+// USB Cmds 0x40 - 0x4f which are Host to Device commands, these only set up RAM
+// variables for maintask(), or queue their EEPROM writes
+#define USB_CMD_OUT_4X(cmd)	(((cmd) == 0x48) || ((cmd) == 0x4a) || ((cmd) == 0x4c) || ((cmd) == 0x4f))
+
 
 
 //
@@ -881,6 +1151,27 @@ typedef struct
 		#if	ENCODER_RESOLUTION				// USB command to modify the Ecoder Resolution
 		uint16_t	Resolvable_States;		// Number of Resolvable States per Revolution
 		#endif
+		#if ENCODER_ACCEL					// Velocity based acceleration curve
+		uint8_t		Enc_Accel[ENC_ACCEL_STEPS];// Encoder click multiplier vs. time between pulses
+		#endif
+		#if CW_KEYER						// Iambic keyer
+		uint8_t		Keyer[KEYER_PARAMS];	// Mode, WPM, weight and PTT hang time
+		#endif
+		#if TR_SEQUENCER					// T/R sequencer
+		uint8_t		TR_Seq[TR_PARAMS];		// TX and RX step delays, mute and antenna relay bits
+		#endif
+		#if SWR_FAST_TRIP					// Fast SWR trip
+		uint8_t		SWR_Trip_Count;			// Samples in a row over the SWR threshold to trip
+		#endif
+		#if BIAS_FAST_CAL					// Fast PA bias calibration
+		uint8_t		Bias_Settle;			// Settle time before each bias reading, in 10ms
+		#endif
+		#if ADC_DECIMATE					// AD7991 decimation filter
+		uint8_t		ADC_Decimate[4];		// 2^n readings per value, for each AD7991 channel
+		#endif
+		#if PWR_CAL_TABLE					// Power calibration table
+		uint8_t		PWR_Cal_Points[PWR_CAL_BANDS];// Number of points in each band table
+		#endif
 		#if PSDR_IQ_OFFSET36				// Display a fixed frequency offset during RX only.
 		int32_t		LCD_RX_Offset;			// Freq add/subtract value is 0.0MHz (11.21bits)
 											// signed integer, 0.000 MHz * 4.0 * _2(21)
@@ -919,6 +1210,73 @@ typedef struct								// USB command structure - from the LUFA library
 	uint16_t wLength; 						//< Notification wLength, notification-specific
 } USB_Notification_Header_t;
 
+#if USB_DEFERRED_CMD						// Defer USB triggered EEPROM writes and I2C traffic
+typedef struct								// Deferred USB command queue entry
+{
+	uint8_t		cmd;						// USBQ_EEPROM, USBQ_PCF or USBQ_MOBO_PCF
+	uint8_t		len;						// Number of data bytes
+	uint16_t	addr;						// EEPROM address or I2C address
+	uint8_t		data[4];					// Data payload (max 4 bytes, a pwr_cal_t point)
+} usbCmd_t;
+#endif
+
+#if USB_TELEMETRY							// Interrupt IN endpoint telemetry stream
+typedef struct								// Telemetry record, sent on the interrupt IN endpoint
+{
+	uint16_t	seq;						// Sequence counter, incremented for every record
+	uint8_t		status1;					// Status1 flags (TX_FLAG, SWR alarm, TMP alarm...)
+	uint8_t		status2;					// Status2 flags (Si570 offline, encoder...)
+	uint32_t	freq;						// Running frequency [MHz] (11.21bits)
+	sint16_t	adc[4];						// AD7991 ADC inputs, full scale 16 bit unsigned int
+	sint16_t	tmp;						// TMP100 temperature
+	uint16_t	swr;						// SWR value x 100
+	#if USB_HOP_LIST						// Firmware timed frequency hop list
+	uint16_t	hop_count;					// Number of hops since start, as Cmd 0x4b
+	uint8_t		hop_entry;					// Current hop list entry, as Cmd 0x4b
+	#endif
+} telemetry_t;
+#endif
+
+#if USB_SNAPSHOT_CMD						// Consistent measurement snapshot, USB Cmd 0x62
+typedef struct								// Measurement snapshot, all values from the same 10ms slot
+{
+	uint16_t	seq;						// Sequence counter, incremented for every snapshot
+	uint8_t		status1;					// Status1 flags (TX_FLAG, SWR alarm, TMP alarm...)
+	uint8_t		status2;					// Status2 flags (Si570 offline, encoder...)
+	uint32_t	freq;						// Running frequency [MHz] (11.21bits)
+	sint16_t	adc[4];						// AD7991 ADC inputs, full scale 16 bit unsigned int
+	sint16_t	tmp;						// TMP100 temperature
+	uint16_t	swr;						// SWR value x 100
+	uint16_t	pwr_out;					// Power output in mW
+	uint16_t	pwr_ref;					// Power reflected in mW
+	uint8_t		filters[2];					// Selected BPF and LPF, as selectedFilters[]
+} snapshot_t;
+#endif
+
+#if CW_KEY_EVENTS							// Timestamped CW key and PTT edges, USB Cmd 0x52
+typedef struct								// CW key or PTT edge
+{
+	uint16_t	time;						// TCNT1 at the edge (1/62500 s)
+	uint8_t		state;						// REG_CWSHORT, REG_CWLONG and REG_TX_state, as Cmd 0x51
+} cw_event_t;
+#endif
+
+#if USB_HOP_LIST							// Firmware timed frequency hop list
+typedef struct								// Hop list entry, loaded with Cmd 0x4a
+{
+	uint32_t	freq;						// Frequency [MHz] (11.21bits)
+	uint16_t	dwell;						// Dwell time in ms
+} hop_t;
+#endif
+
+#if PWR_CAL_TABLE							// Power calibration table
+typedef struct								// Power calibration point, loaded with Cmd 0x4f
+{
+	uint16_t	adc;						// AD reading, MSB aligned as ad7991_adc[]
+	uint16_t	mw;							// Power in mW, 12 bits mantissa, 4 bits exponent
+} pwr_cal_t;
+#endif
+
 
 // Various global variables
 extern	EEMEM 		var_t E;				// Default Variables in EEPROM
@@ -942,6 +1300,11 @@ extern	uint8_t		selectedFilters[];		// Contains info on which filters are select
 extern	uint8_t 	pcf_data_out;			// Data to onboard PCF8574 register
 											// This variable used for the builtin PCF8574 on the Mobo 4.3
 
+#if USB_TELEMETRY							// Interrupt IN endpoint telemetry stream
+extern	telemetry_t	telemetry;				// Telemetry record, sent by USB-EP0.c
+extern	uint8_t		telemetry_ready;		// A new telemetry record is waiting to be sent
+#endif
+
 // prototypes for Mobo_ABPF.c
 #if CALC_BAND_MUL_ADD						// Band dependent Frequency Subtract and Multiply
 extern	uint8_t		SetFilter(uint32_t);
@@ -961,6 +1324,10 @@ extern	void		tmp100(uint8_t);				// Read temperature from TMP100 device
 extern	void		ad5301(uint8_t, uint8_t);		// Write data to the AD5301 DAC
 extern	void		ad7991_setup(uint8_t);			// Setup AD7991 to do interesting stuff
 extern	void		ad7991_poll(uint8_t);			// Poll the AD7991 4 x ADC chip
+#if ADC_DECIMATE									// AD7991 decimation filter, USB Cmd 0x59
+extern	uint8_t		adc_fresh;						// Channels dumped since taken, 1 bit each
+extern	void		adc_decimate_restart(uint8_t);	// Start a channel's sum over
+#endif
 
 
 // prototypes for Mobo_PWR_SWR_and_Bias_cal.c
@@ -968,7 +1335,59 @@ extern void			Test_SWR(void);					// Do SWR calcultions and control the PTT2 out
 
 
 extern uint16_t		measured_Power(uint16_t);		// Convert AD reading into "Measured Power in milliWatts"
+#if FAST_METERING || SWR_FAST_TRIP
+extern void			meter_update(void);				// Work out the metering constants from R
+extern uint16_t		meter_trigger;					// AD reading for R.P_Min_Trigger
+#endif
+#if SWR_FAST_TRIP
+extern void			SWR_fast_trip(void);			// Fast SWR trip, called by maintask()
+extern uint16_t		swr_trip_k;						// SWR threshold, 10 x R.SWR_Trigger + 1
+extern uint16_t		swr_trip_time;					// Reaction time of the last trip
+extern uint16_t		swr_trips;						// Number of fast trips
+extern uint8_t		swr_trip_polled;				// AD7991 polled since the last 10ms poll
+#endif
+#if PWR_CAL_TABLE									// Power calibration table, USB Cmds 0x4f, 0x5a, 0x5b
+extern uint32_t		cal_Power(uint16_t);			// Convert AD reading into mW, 32 bits
+extern void			pwr_cal_update(void);			// Follow the TX filter to the band table in use
+extern void			pwr_cal_reload(void);			// Work out the slopes of the band table in use
+extern void			pwr_cal_point(uint8_t, uint8_t, pwr_cal_t *);// Point loaded by Cmd 0x4f
+extern uint16_t		pwr_cal_pack(uint32_t);			// mW into the pwr_cal_t format
+extern uint32_t		pwr_cal_unpack(uint16_t);		// and back
+extern uint8_t		pwr_cal_band;					// Band table in use
+extern EEMEM pwr_cal_t	E_PwrCal[PWR_CAL_BANDS][PWR_CAL_POINTS];// Band tables in EEPROM
+#endif
+#if PEP_METER										// PEP, average and peak hold, USB Cmd 0x57
+extern void			pep_update(void);				// Add an AD7991 reading, called by maintask()
+extern uint16_t		pep_power;						// PEP in mW, highest within the PEP window
+extern uint16_t		pep_average(void);				// Running average power in mW
+extern uint16_t		pep_hold;						// Peak hold in mW, highest since cleared
+#endif
+extern uint16_t		calc_SWR(uint16_t, uint16_t);	// Calculate SWR x 100 from forward and reflected readings
+#if BIAS_FAST_CAL									// Fast PA bias calibration, USB Cmd 0x58
+extern uint8_t		bias_cal_status;				// BIAS_CAL_IDLE, BIAS_CAL_RUN, ...
+extern uint8_t		bias_cal_steps;					// Bias readings taken
+extern uint8_t		bias_cal_probe;					// Bias setting being measured
+extern uint8_t		bias_cal_current;				// Last PA current reading, in 10 * mA
+#endif
+#if SWR_SWEEP										// SWR sweep, USB Cmds 0x4c - 0x4e
+extern void			SWR_sweep(void);				// Step the SWR sweep, called by maintask()
+extern uint32_t		sweep_freq;						// Frequency of the next point
+extern uint32_t		sweep_step;						// Frequency step
+extern uint32_t		sweep_restore;					// Running frequency before the sweep
+extern uint8_t		sweep_points;					// Number of points in the sweep
+extern uint8_t		sweep_done;						// Number of points measured
+extern uint8_t		sweep_settle;					// Settle time after keying, in ms
+extern uint8_t		sweep_state;					// SWEEP_IDLE, SWEEP_ABORTED, ...
+extern uint8_t		sweep_swr[SWEEP_POINTS];		// SWR x 10 of each point
+#endif
 extern void			PA_bias(void);					// RD16HHF1 PA Bias management
+#if TR_SEQUENCER
+extern void			tr_ptt(uint8_t);				// Start a TX or RX sequence
+extern uint8_t		tr_sequence(void);				// Do the steps which are due, called by maintask()
+extern uint8_t		tr_pos;							// Number of TX steps in effect
+extern uint8_t		tr_target;						// TR_STEPS for TX, 0 for RX
+extern uint16_t		tr_measured[];					// Duration of the last TX and RX sequences
+#endif
 
 				
 // prototypes for Mobo_LCD_Display.c
@@ -987,6 +1406,11 @@ extern void			lcd_display_Memory_Stored(void);// Display Memory Stored for a cer
 // prototypes for Mobo_LCD_bargraph_lowlevel.c
 extern void			lcdProgressBar(uint16_t, uint16_t, uint8_t);		// Draw a bargraph on LCD
 extern void			lcd_bargraph_init(void);		// Load the custom bargraph charaters to LCD
+#if BARGRAPH_FAST
+extern void			lcdBargraph(uint8_t, uint16_t, uint16_t, uint8_t, uint8_t, uint8_t);// Draw changes of a bargraph
+extern void			lcd_bargraph_frame(void);		// Start of a display pass
+extern void			lcd_bargraph_redraw(void);		// Bargraphs overwritten, draw all of them again
+#endif
 
 
 // prototypes for Mobo_ShaftEncoder.c
@@ -996,9 +1420,35 @@ extern void 		shaftEncoderInit(void);			// Initialise the VFO Shaft Encoder
 #if ENCODER_SCAN_STYLE								// Shaft Encoder which scans the GPIO inputs
 extern void			encoder_scan(void);				// Scan the Shaft Encoder
 #endif
+#if ENCODER_INT_STYLE								// Interrupt driven Shaft Encoder
+extern void			encoder_update(void);			// Apply the encoder ticks gathered by the interrupt
+#if ENCODER_RESOLUTION
+extern void			encoder_resolution_update(void);// Derive scaling constants from Resolvable States
+#endif
+#endif
+#if ENCODER_INT_STYLE && ENCODER_INT_TABLE			// Interrupt on both phases, table driven decoder
+extern uint16_t		enc_invalid;					// Number of invalid encoder transitions seen
+#endif
+#if ENCODER_INT_STYLE && ENCODER_FAST_RETUNE		// Write encoder frequency changes without delay
+extern void			encoder_retuned(void);			// Si570 written, measure the latency
+extern uint16_t		enc_latency[];					// Last and max encoder pulse to Si570 latency
+#endif
+
+
+#if CW_KEYER
+// prototypes for Mobo_CW_Keyer.c
+extern void			keyerInit(void);				// Start the 1ms keyer interrupt
+extern void			keyer_update(void);				// Derive element timing from R.Keyer[]
+extern void			keyer_ptt_update(void);			// Apply keyer PTT changes, called by maintask()
+extern volatile uint8_t keyer_key;					// Key down, as sent by the keyer
+#endif
+#if CW_KEY_EVENTS
+extern void			cw_edge(uint16_t);				// Queue CW key and PTT edges, in Mobo.c
+#endif
 
 
 // prototyes for DeviceSi570.c
+extern	Si570_t		Si570_Data;						// Si570 register values, as last written
 extern	uint8_t		GetRegFromSi570(void);
 extern	void		SetFreq(uint32_t freq);
 extern	void		DeviceInit(void);
@@ -0,0 +1,244 @@
+//*********************************************************************************
+//**
+//** Project.........: USB controller firmware for the Softrock 6.3 SDR,
+//**                   enhanced with the 9V1AL Motherboard, F6ITU LPF bank
+//**                   and other essentials to create an all singing and
+//**                   all dancing HF SDR amateur radio transceiver
+//**
+//**                   Initial Core project team: 9V1AL, F6ITU, KF4BQ, KY1K
+//**                   TF3LJ & many more
+//**
+//** Platform........: AT90USB162 @ 16MHz
+//**
+//** Licence.........: This software is freely available for non-commercial
+//**                   use - i.e. for research and experimentation only!
+//**
+//**
+//** Initial version.: 2026-10-19
+//**                   Check the Mobo.c file
+//**
+//** Iambic A/B keyer.  The paddles on the CW key inputs are sampled, and the
+//**                   elements timed, by a 1ms Timer1 compare interrupt, so that
+//**                   the element timing does not depend on USB round trips or
+//**                   on the load of the host.  Key down is reported to the host
+//**                   in Cmd 0x51 (and Cmd 0x52), the PTT is switched by the
+//**                   mainloop.  Speed, weight, PTT hang time and mode are set
+//**                   with Cmd 0x53.
+//**
+//*********************************************************************************
+
+
+#include "Mobo.h"
+
+#if CW_KEYER					// Iambic keyer
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+// Paddles, as sampled
+#define KEYER_DIT		0x01
+#define KEYER_DAH		0x02
+
+// Keyer states
+#define KS_IDLE			0					// Transmitter released
+#define KS_MARK			1					// Sending an element
+#define KS_SPACE		2					// Space after an element
+#define KS_HANG			3					// Waiting for the next character, PTT still on
+
+volatile uint8_t keyer_key;					// Key down, as sent by the keyer
+volatile uint8_t keyer_ptt;					// PTT, as requested by the keyer
+
+static uint16_t	keyer_dit;					// Dit length in ms, including the weight
+static uint16_t	keyer_dah;					// Dah length in ms, including the weight
+static uint16_t	keyer_space;				// Element space in ms, less the weight
+static uint16_t	keyer_hang;					// PTT hang time in ms
+
+static uint8_t	keyer_state;				// KS_IDLE, KS_MARK, ...
+static uint16_t	keyer_timer;				// ms left in the current state
+static uint8_t	keyer_last = KEYER_DAH;		// Last element sent, a squeeze starts with a dit
+static uint8_t	keyer_memory;				// Opposite paddle pressed during an element (mode B)
+static uint8_t	keyer_sample;				// Previous paddle sample
+
+
+//
+//-----------------------------------------------------------------------------------------
+// 			Derive the element timing from the keyer parameters in R.Keyer[]
+//
+//			Weight moves time from the element space into the element,
+//			50 = 1:1, 75 = 1.5 dit element and 0.5 dit space
+//-----------------------------------------------------------------------------------------
+//
+void keyer_update(void)
+{
+	uint8_t wpm = R.Keyer[KEYER_WPM];
+	uint8_t weight = R.Keyer[KEYER_WEIGHT];
+	int16_t dit, extra;
+
+	if (wpm < 5) wpm = 5;
+	if (wpm > 60) wpm = 60;
+	if (weight < 25) weight = 25;
+	if (weight > 75) weight = 75;
+
+	dit = 1200 / wpm;						// PARIS standard, dit length in ms
+	extra = dit * (weight - 50) / 50;
+
+	cli();
+	keyer_dit = dit + extra;
+	keyer_dah = 3 * dit + extra;
+	keyer_space = dit - extra;
+	keyer_hang = R.Keyer[KEYER_HANG] * 10;
+	sei();
+}
+
+
+//
+//-----------------------------------------------------------------------------------------
+// 			Start the keyer
+//
+//			Timer1 is left free running (Mobo.c uses it as a time base), the keyer
+//			interrupt steps the Timer1 compare A register by 1ms at a time
+//-----------------------------------------------------------------------------------------
+//
+void keyerInit(void)
+{
+	keyer_update();
+	OCR1A = TCNT1 + KEYER_TICK;
+	TIMSK1 |= (1 << OCIE1A);				// Timer1 compare A interrupt
+	sei();
+}
+
+
+//
+//-----------------------------------------------------------------------------------------
+// 			Apply keyer PTT changes, called by maintask()
+//
+//			The PTT is switched here rather than in the interrupt, as the Mobo PTT
+//			is a PCF8574 output written through I2C.  Inhibits as for Cmd 0x50
+//-----------------------------------------------------------------------------------------
+//
+void keyer_ptt_update(void)
+{
+	static uint8_t tx;						// PTT, as last applied
+
+	if (keyer_ptt == tx) return;
+	tx = keyer_ptt;
+
+	#if TR_SEQUENCER						// T/R sequence, the steps are done by maintask()
+	tr_ptt(tx);
+	#else
+	if (tx)
+	{
+		Status1 |= TX_FLAG;					// Set the TX flag
+
+		// Set PTT if there are no inhibits
+		if (!(Status1 & (TMP_ALARM | PA_CAL)))
+		{
+			biasInit = 0;					// Ensure that correct bias is set by PA_bias()
+
+			#if MOBO_STYLE_IO
+			MoboPCF_clear(Mobo_PCF_TX);
+			#endif//MOBO_STYLE_IO
+			#if OLDSTYLE_IO
+			IO_PORT_PTT_CWKEY |= IO_PTT;
+			#endif//OLDSTYLE_IO
+		}
+	}
+	else
+	{
+		Status1 &= ~TX_FLAG;				// Clear the TX flag
+		#if MOBO_STYLE_IO
+		MoboPCF_set(Mobo_PCF_TX);
+		#endif//MOBO_STYLE_IO
+		#if OLDSTYLE_IO
+		IO_PORT_PTT_CWKEY &= ~IO_PTT;
+		#endif//OLDSTYLE_IO
+	}
+	#endif//TR_SEQUENCER
+}
+
+
+//
+//-----------------------------------------------------------------------------------------
+// 			Set the key, and report the change as a CW key edge
+//-----------------------------------------------------------------------------------------
+//
+static void keyer_set_key(uint8_t key)
+{
+	if (key == keyer_key) return;
+	keyer_key = key;
+	#if CW_KEY_EVENTS						// Timestamped CW key and PTT edges
+	cw_edge(TCNT1);
+	#endif
+}
+
+
+//
+//-----------------------------------------------------------------------------------------
+// 			Keyer, run every 1ms by the Timer1 compare A interrupt
+//
+//			The key inputs have pullups, a closed paddle reads 0.  A paddle has to
+//			read closed twice in a row, 1ms apart, to count as pressed
+//-----------------------------------------------------------------------------------------
+//
+ISR(TIMER1_COMPA_vect)
+{
+	static uint8_t frac;					// Adds the half tick on every other interrupt
+	uint8_t sample = 0;
+	uint8_t paddles;
+
+	OCR1A += KEYER_TICK + (frac ^= 1);		// 62.5 ticks of 1/62500 s = 1ms
+
+	if (!(R.Keyer[KEYER_MODE] & KEYER_ON))	// Keyer disabled
+	{
+		keyer_state = KS_IDLE;
+		keyer_memory = 0;
+		keyer_set_key(False);
+		keyer_ptt = False;
+		return;
+	}
+
+	if (!(IO_PIN_PTT_CWKEY & IO_CWKEY1)) sample |= KEYER_DIT;
+	if (!(IO_PIN_PTT_CWKEY & IO_CWKEY2)) sample |= KEYER_DAH;
+	if (R.Keyer[KEYER_MODE] & KEYER_SWAP) sample = ((sample << 1) | (sample >> 1)) & (KEYER_DIT | KEYER_DAH);
+	paddles = sample & keyer_sample;
+	keyer_sample = sample;
+
+	if ((keyer_state == KS_MARK) || (keyer_state == KS_SPACE))
+	{
+		if (R.Keyer[KEYER_MODE] & KEYER_IAMBIC_B)
+			keyer_memory |= paddles & ~keyer_last;// Remember the opposite paddle
+		if (--keyer_timer)
+			return;
+		if (keyer_state == KS_MARK)			// Element sent, start the space
+		{
+			keyer_set_key(False);
+			keyer_state = KS_SPACE;
+			keyer_timer = keyer_space;
+			return;
+		}
+		// Space done, go on with the next element or the hang time
+		keyer_state = KS_HANG;
+		keyer_timer = keyer_hang + 1;
+	}
+
+	// Idle, hang time, or end of an element space
+	paddles |= keyer_memory;
+	keyer_memory = 0;
+	if (paddles)
+	{
+		if (paddles == (KEYER_DIT | KEYER_DAH))	// Squeeze, alternate the elements
+			keyer_last ^= (KEYER_DIT | KEYER_DAH);
+		else
+			keyer_last = paddles;
+		keyer_state = KS_MARK;
+		keyer_timer = (keyer_last == KEYER_DIT) ? keyer_dit : keyer_dah;
+		keyer_ptt = True;
+		keyer_set_key(True);
+	}
+	else if ((keyer_state == KS_HANG) && !--keyer_timer)
+	{
+		keyer_state = KS_IDLE;				// Character done, release the transmitter
+		keyer_ptt = False;
+	}
+}
+#endif
@@ -72,7 +72,7 @@ void lcd_putchar_P(const char *addr)
 //-----------------------------------------------------------------------------
 //
 
-#if PWR_PEAK_ENVELOPE							//PEP measurement. Highest value in buffer shown
+#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 static uint16_t pow_avg[PEP_MAX_PERIOD];		// Power measurement ringbuffer
 #endif
 
@@ -103,6 +103,9 @@ void lcd_display_TRX_stuff(void)
 {
 	lcd_clrscr();								// Clear Screen is a cheaper operation than
 												// writing blanks, though it causes flicker
+	#if BARGRAPH_FAST
+	lcd_bargraph_redraw();						// Bargraphs cleared
+	#endif
 
 	lcd_display_freq_and_filters();				// Update frequency display
 	lcd_display_P_SWR_V_C_T();					// Update 2nd line, Temp, V, I...
@@ -118,7 +121,7 @@ void lcd_display_TRX_stuff(void)
 	{
 		lcd_data('R');
 
-		#if PWR_PEAK_ENVELOPE						//PEP measurement. Highest value in buffer shown
+		#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 		for (uint8_t j = 0; j < PEP_MAX_PERIOD; j++)// Clear PEP storage during receive
 		{
 			pow_avg[j]=0;
@@ -233,7 +236,7 @@ void lcd_display_P_SWR_V_C_T(void)
 	#endif
 	
 	// Prep Voltage readout.  Max voltage = 15.6V (5V * 14.7k/4.7k)
-	uint16_t vdd_tenths = ((uint32_t) ad7991_adc[AD7991_PSU_VOLTAGE].w * 156) / 0xfff0;
+	uint16_t vdd_tenths = AD7991_VOLT_X10(ad7991_adc[AD7991_PSU_VOLTAGE].w);
 	uint16_t vdd = vdd_tenths / 10;
 	vdd_tenths = vdd_tenths % 10;
 	
@@ -248,7 +251,7 @@ void lcd_display_P_SWR_V_C_T(void)
 	if (Status1 & (PA_CAL | TX_FLAG))
 	{
 		// Fetch and normalize PA current
-		uint16_t idd_ca = ad7991_adc[AD7991_PA_CURRENT].w / 262;
+		uint16_t idd_ca = AD7991_AMP_X100(ad7991_adc[AD7991_PA_CURRENT].w);
 		uint16_t idd = idd_ca/100; idd_ca = idd_ca%100;
 	
 		lcd_gotoxy(13,1);							// Second line, 13th position
@@ -314,9 +317,13 @@ void lcd_display_P_SWR_V_C_T(void)
 		uint16_t pow_tot, pow, pow_mw;
 
 		// Prepare Power readout
+		#if PWR_PEAK_ENVELOPE && PEP_METER		// PEP from the metering stage, USB Cmd 0x57
+		pow_tot = pep_power;
+		#else
 		pow_tot = measured_Power(ad7991_adc[AD7991_POWER_OUT].w);// Power in mW (max 65535mW)
+		#endif
 
-		#if PWR_PEAK_ENVELOPE						//PEP measurement. Highest value in buffer shown
+		#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 		static uint8_t i = 0;
 
 		#if	PWR_PEP_ADJUST							// Option to adjust the number of samples in PEP measurement
@@ -343,7 +350,11 @@ void lcd_display_P_SWR_V_C_T(void)
 		#endif
 
 		// progress, maxprogress, len
+		#if BARGRAPH_FAST
+		lcdBargraph(BAR_PWR, pow_tot/100, R.PWR_fullscale*10, 0, 2, 12);
+		#else
 		lcdProgressBar(pow_tot/100, R.PWR_fullscale*10, 12);
+		#endif
 
 		pow = pow_tot / 1000; 						// Watts
 		pow_mw = pow_tot % 1000;					// milliWatts
@@ -367,10 +378,18 @@ void lcd_display_P_SWR_V_C_T(void)
 		#if	BARGRAPH_SWR_SCALE						// Add option to adjust the Fullscale value for the SWR bargraph
 		// possible bug fix for SWR lcdProgressBar exceeding range
 		uint16_t display_SWR = ((measured_SWR-100) > R.SWR_fullscale*100) ? R.SWR_fullscale*100 : (measured_SWR-100);
+		#if BARGRAPH_FAST
+		lcdBargraph(BAR_SWR, display_SWR, R.SWR_fullscale*100, 0, 3, 12);
+		#else
 		lcdProgressBar(display_SWR, R.SWR_fullscale*100, 12);
+		#endif
 		#else
 		display_SWR = ((measured_SWR-100) > R.SWR_fullscale*100) ? SWR_FULL_SCALE : (measured_SWR-100);
+		#if BARGRAPH_FAST
+		lcdBargraph(BAR_SWR, display_SWR - 100, SWR_FULL_SCALE, 0, 3, 12);
+		#else
 		lcdProgressBar(display_SWR - 100, SWR_FULL_SCALE, 12);
+		#endif
 		#endif	
 
 		lcd_putchar_P(PSTR("SWR"));					// Print string from flash rom
@@ -416,6 +435,9 @@ void lcd_display_Memory_Stored(void)				// Display Memory Stored for a certain a
 
 	lcd_gotoxy(0,3);								// Fourth line
 	lcd_putchar_P(PSTR("VFO Memory Stored   "));	// Print string from flash rom rather than from SRAM
+	#if BARGRAPH_FAST
+	lcd_bargraph_redraw();						// SWR Bargraph overwritten
+	#endif
 
 	count++;
 	if(count>=ENC_STORE_DISP)
@@ -439,7 +461,7 @@ void lcd_display_Memory_Stored(void)				// Display Memory Stored for a certain a
 //-----------------------------------------------------------------------------
 //
 
-#if PWR_PEAK_ENVELOPE							//PEP measurement. Highest value in buffer shown
+#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 static uint16_t pow_avg[PEP_MAX_PERIOD];		// Power measurement ringbuffer
 #endif
 
@@ -470,6 +492,9 @@ void lcd_display_TRX_stuff(void)
 {
 	lcd_clrscr();								// Clear Screen is a cheaper operation than
 												// writing blanks, though it causes flicker
+	#if BARGRAPH_FAST
+	lcd_bargraph_redraw();						// Bargraphs cleared
+	#endif
 
 	lcd_display_freq_and_filters();				// Update frequency display
 	lcd_display_P_SWR_V_C_T();					// Update 2nd line, Temp, V, I...
@@ -485,7 +510,7 @@ void lcd_display_TRX_stuff(void)
 	{
 		lcd_data('R');
 
-		#if PWR_PEAK_ENVELOPE						//PEP measurement. Highest value in buffer shown
+		#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 		for (uint8_t j = 0; j < PEP_MAX_PERIOD; j++)// Clear PEP storage during receive
 		{
 			pow_avg[j]=0;
@@ -600,7 +625,7 @@ void lcd_display_P_SWR_V_C_T(void)
 	#endif
 	
 	// Prep Voltage readout.  Max voltage = 15.6V (5V * 14.7k/4.7k)
-	uint16_t vdd_tenths = ((uint32_t) ad7991_adc[AD7991_PSU_VOLTAGE].w * 156) / 0xfff0;
+	uint16_t vdd_tenths = AD7991_VOLT_X10(ad7991_adc[AD7991_PSU_VOLTAGE].w);
 	uint16_t vdd = vdd_tenths / 10;
 	vdd_tenths = vdd_tenths % 10;
 	
@@ -615,7 +640,7 @@ void lcd_display_P_SWR_V_C_T(void)
 	if (Status1 & (PA_CAL | TX_FLAG))
 	{
 		// Fetch and normalize PA current
-		uint16_t idd_ca = ad7991_adc[AD7991_PA_CURRENT].w / 262;
+		uint16_t idd_ca = AD7991_AMP_X100(ad7991_adc[AD7991_PA_CURRENT].w);
 		uint16_t idd = idd_ca/100; idd_ca = idd_ca%100;
 	
 		lcd_gotoxy(13,1);							// Second line, 13th position
@@ -681,9 +706,13 @@ void lcd_display_P_SWR_V_C_T(void)
 		uint16_t pow_tot, pow, pow_mw;
 
 		// Prepare Power readout
+		#if PWR_PEAK_ENVELOPE && PEP_METER		// PEP from the metering stage, USB Cmd 0x57
+		pow_tot = pep_power;
+		#else
 		pow_tot = measured_Power(ad7991_adc[AD7991_POWER_OUT].w);// Power in mW (max 65535mW)
+		#endif
 
-		#if PWR_PEAK_ENVELOPE						//PEP measurement. Highest value in buffer shown
+		#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 		static uint8_t i = 0;
 
 		#if	PWR_PEP_ADJUST							// Option to adjust the number of samples in PEP measurement
@@ -710,7 +739,11 @@ void lcd_display_P_SWR_V_C_T(void)
 		#endif
 
 		// progress, maxprogress, len
+		#if BARGRAPH_FAST
+		lcdBargraph(BAR_PWR, pow_tot/100, R.PWR_fullscale*10, 20, 0, 12);
+		#else
 		lcdProgressBar(pow_tot/100, R.PWR_fullscale*10, 12);
+		#endif
 
 		pow = pow_tot / 1000; 						// Watts
 		pow_mw = pow_tot % 1000;					// milliWatts
@@ -734,10 +767,18 @@ void lcd_display_P_SWR_V_C_T(void)
 		#if	BARGRAPH_SWR_SCALE						// Add option to adjust the Fullscale value for the SWR bargraph
 		// possible bug fix for SWR exceeding lcdProgressBar range
 		uint16_t display_SWR = ((measured_SWR-100) > R.SWR_fullscale*100) ? R.SWR_fullscale*100 : (measured_SWR-100);
+		#if BARGRAPH_FAST
+		lcdBargraph(BAR_SWR, display_SWR, R.SWR_fullscale*100, 20, 1, 12);
+		#else
 		lcdProgressBar(display_SWR, R.SWR_fullscale*100, 12);
+		#endif
 		#else
 		display_SWR = ((measured_SWR-100) > R.SWR_fullscale*100) ? SWR_FULL_SCALE : (measured_SWR-100);
+		#if BARGRAPH_FAST
+		lcdBargraph(BAR_SWR, display_SWR - 100, SWR_FULL_SCALE, 20, 1, 12);
+		#else
 		lcdProgressBar(display_SWR - 100, SWR_FULL_SCALE, 12);
+		#endif
 		#endif	
 
 		lcd_putchar_P(PSTR("SWR"));					// Print string from flash rom
@@ -783,6 +824,9 @@ void lcd_display_Memory_Stored(void)				// Display Memory Stored for a certain a
 
 	lcd_gotoxy(20,1);								// Second half, second line	
 	lcd_putchar_P(PSTR(" VFO Memory Stored  "));	// Print string from flash rom rather than from SRAM
+	#if BARGRAPH_FAST
+	lcd_bargraph_redraw();						// SWR Bargraph overwritten
+	#endif
 
 	count++;
 	if(count>=ENC_STORE_DISP)
@@ -928,20 +972,24 @@ void lcd_display(void)
 	#endif
 
 	// Prep Voltage readout.  Max voltage = 15.6V (5V * 14.7k/4.7k)
-	vdd_tot = ((uint32_t) ad7991_adc[AD7991_PSU_VOLTAGE].w * 156) / 0xfff0;
+	vdd_tot = AD7991_VOLT_X10(ad7991_adc[AD7991_PSU_VOLTAGE].w);
 	vdd = vdd_tot / 10;
 	vdd_tenths = vdd_tot % 10;
 
 	// Fetch and normalize PA current
-	uint16_t idd_ca = ad7991_adc[AD7991_PA_CURRENT].w / 262;
+	uint16_t idd_ca = AD7991_AMP_X100(ad7991_adc[AD7991_PA_CURRENT].w);
 	uint16_t idd = idd_ca / 100; 
 	idd_ca = idd_ca % 100;
 
 	#if POWER_SWR									// Power and SWR measurement
 	// Prepare Power readout
+	#if PWR_PEAK_ENVELOPE && PEP_METER		// PEP from the metering stage, USB Cmd 0x57
+	pow_tot = pep_power;
+	#else
 	pow_tot = measured_Power(ad7991_adc[AD7991_POWER_OUT].w);// Power in mW (max 65535mW)
+	#endif
 
-	#if PWR_PEAK_ENVELOPE							//PEP measurement. Highest value in buffer shown
+	#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 	static uint16_t pow_avg[PEP_MAX_PERIOD];		// Power measurement ringbuffer
 
 	if (R.PEP_samples > PEP_MAX_PERIOD) R.PEP_samples = PEP_MAX_PERIOD;// Safety measure
@@ -1087,7 +1135,7 @@ void lcd_display(void)
 	//-------------------------------------------
 	else
 	{
-		#if PWR_PEAK_ENVELOPE						//PEP measurement. Highest value in buffer shown
+		#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 		for (uint8_t j = 0; j < PEP_MAX_PERIOD; j++)// Clear PEP storage during receive
 		{
 			pow_avg[j]=0;
@@ -1159,7 +1207,7 @@ void lcd_display(void)
 	// AVRLIB floating point printf formatting would be very costly in size
 	uint16_t vdd_tot, vdd, vdd_tenths, swr, swr_hundredths, swr_tenths, pow_tot, pow, pow_mw;
 
-	#if PWR_PEAK_ENVELOPE						//PEP measurement. Highest value in buffer shown
+	#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 	static uint16_t pow_avg[PEP_MAX_PERIOD];	// Power measurement ringbuffer
 
 	if (R.PEP_samples > PEP_MAX_PERIOD) R.PEP_samples = PEP_MAX_PERIOD;// Safety measure
@@ -1204,9 +1252,13 @@ void lcd_display(void)
 	else if(Status1 & TX_FLAG)
 	{
 		// Prepare Power readout
+		#if PWR_PEAK_ENVELOPE && PEP_METER		// PEP from the metering stage, USB Cmd 0x57
+		pow_tot = pep_power;
+		#else
 		pow_tot = measured_Power(ad7991_adc[AD7991_POWER_OUT].w);// Power in mW (max 65535mW)
+		#endif
 
-		#if PWR_PEAK_ENVELOPE						//PEP measurement. Highest value in buffer shown
+		#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 		static uint8_t i = 0;
 
 		#if	PWR_PEP_ADJUST							// Option to adjust the number of samples in PEP measurement
@@ -1233,7 +1285,11 @@ void lcd_display(void)
 		#endif
 
 		// progress, maxprogress, len
+		#if BARGRAPH_FAST
+		lcdBargraph(BAR_PWR, pow_tot/100, R.PWR_fullscale*10, 0, 0, 8);
+		#else
 		lcdProgressBar(pow_tot/100, R.PWR_fullscale*10, 8);
+		#endif
 
 		pow = pow_tot / 1000; 						// Watts
 		pow_mw = pow_tot % 1000;					// milliWatts
@@ -1249,7 +1305,7 @@ void lcd_display(void)
 	//-------------------------------------------------------
 	else
 	{
-		#if PWR_PEAK_ENVELOPE						//PEP measurement. Highest value in buffer shown
+		#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 		for (uint8_t j = 0; j < PEP_MAX_PERIOD; j++)	// Clear PEP storage during receive
 		{
 			pow_avg[j]=0;
@@ -1304,7 +1360,7 @@ void lcd_display(void)
 	#endif
 
 	// Prep Voltage readout.  Max voltage = 15.6V (5V * 14.7k/4.7k)
-	vdd_tot = ((uint32_t) ad7991_adc[AD7991_PSU_VOLTAGE].w * 156) / 0xfff0;
+	vdd_tot = AD7991_VOLT_X10(ad7991_adc[AD7991_PSU_VOLTAGE].w);
 	vdd = vdd_tot / 10;
 	vdd_tenths = vdd_tot % 10;
 
@@ -1334,7 +1390,7 @@ void lcd_display(void)
 		else if(Status1 & PA_CAL)
 		{
 			// Fetch and normalize PA current
-			uint16_t idd_ca = ad7991_adc[AD7991_PA_CURRENT].w / 262;
+			uint16_t idd_ca = AD7991_AMP_X100(ad7991_adc[AD7991_PA_CURRENT].w);
 			uint16_t idd = idd_ca / 100; 
 			idd_ca = idd_ca % 100;
 
@@ -1362,10 +1418,18 @@ void lcd_display(void)
 		
 		// possible bug fix for SWR exceeding lcdProgressBar range
 		uint16_t display_SWR = ((measured_SWR-100) > R.SWR_fullscale*100) ? R.SWR_fullscale*100 : (measured_SWR-100);
+		#if BARGRAPH_FAST
+		lcdBargraph(BAR_SWR, display_SWR, R.SWR_fullscale*100, 0, 1, 12);
+		#else
 		lcdProgressBar(display_SWR, R.SWR_fullscale*100, 12);
+		#endif
 		#else
 		display_SWR = ((measured_SWR-100) > R.SWR_fullscale*100) ? SWR_FULL_SCALE : (measured_SWR-100);
+		#if BARGRAPH_FAST
+		lcdBargraph(BAR_SWR, display_SWR - 100, SWR_FULL_SCALE, 0, 1, 12);
+		#else
 		lcdProgressBar(display_SWR - 100, SWR_FULL_SCALE, 12);
+		#endif
 		#endif	
 
 
@@ -1455,7 +1519,7 @@ void lcd_display(void)
 	// AVRLIB floating point printf formatting would be very costly in size
 	uint16_t vdd_tot, vdd, vdd_tenths, swr, swr_hundredths, swr_tenths, pow_tot, pow, pow_mw;
 	
-	#if PWR_PEAK_ENVELOPE							//PEP measurement. Highest value in buffer shown
+	#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 	static uint16_t pow_avg[PEP_MAX_PERIOD];		// Power measurement ringbuffer
 
 	if (R.PEP_samples > PEP_MAX_PERIOD) R.PEP_samples = PEP_MAX_PERIOD;// Safety measure
@@ -1501,9 +1565,13 @@ void lcd_display(void)
 	else if(Status1 & TX_FLAG)
 	{
 		// Prepare Power readout
+		#if PWR_PEAK_ENVELOPE && PEP_METER		// PEP from the metering stage, USB Cmd 0x57
+		pow_tot = pep_power;
+		#else
 		pow_tot = measured_Power(ad7991_adc[AD7991_POWER_OUT].w);// Power in mW (max 65535mW)
+		#endif
 
-		#if PWR_PEAK_ENVELOPE						//PEP measurement. Highest value in buffer shown
+		#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 		static uint8_t i = 0;
 
 		#if	PWR_PEP_ADJUST							// Option to adjust the number of samples in PEP measurement
@@ -1530,7 +1598,11 @@ void lcd_display(void)
 		#endif
 
 		// progress, maxprogress, len
+		#if BARGRAPH_FAST
+		lcdBargraph(BAR_PWR, pow_tot/100, R.PWR_fullscale*10, 0, 0, 12);
+		#else
 		lcdProgressBar(pow_tot/100, R.PWR_fullscale*10, 12);
+		#endif
 
 		pow = pow_tot / 1000; 						// Watts
 		pow_mw = pow_tot % 1000;					// milliWatts
@@ -1546,7 +1618,7 @@ void lcd_display(void)
 	//-------------------------------------------------------
 	else
 	{
-		#if PWR_PEAK_ENVELOPE						//PEP measurement. Highest value in buffer shown
+		#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 		for (uint8_t j = 0; j < PEP_MAX_PERIOD; j++)// Clear PEP storage during receive
 		{
 			pow_avg[j]=0;
@@ -1597,7 +1669,7 @@ void lcd_display(void)
 	#endif
 
 	// Prep Voltage readout.  Max voltage = 15.6V (5V * 14.7k/4.7k)
-	vdd_tot = ((uint32_t) ad7991_adc[AD7991_PSU_VOLTAGE].w * 156) / 0xfff0;
+	vdd_tot = AD7991_VOLT_X10(ad7991_adc[AD7991_PSU_VOLTAGE].w);
 	vdd = vdd_tot / 10;
 	vdd_tenths = vdd_tot % 10;
 
@@ -1627,7 +1699,7 @@ void lcd_display(void)
 		else if(Status1 & PA_CAL)
 		{
 			// Fetch and normalize PA current
-			uint16_t idd_ca = ad7991_adc[AD7991_PA_CURRENT].w / 262;
+			uint16_t idd_ca = AD7991_AMP_X100(ad7991_adc[AD7991_PA_CURRENT].w);
 			uint16_t idd = idd_ca / 100; 
 			idd_ca = idd_ca % 100;
 
@@ -1654,10 +1726,18 @@ void lcd_display(void)
 			#if	BARGRAPH_SWR_SCALE					// Add option to adjust the Fullscale value for the SWR bargraph
 		// possible bug fix for SWR exceeding lcdProgressBar range
 		uint16_t display_SWR = ((measured_SWR-100) > R.SWR_fullscale*100) ? R.SWR_fullscale*100 : (measured_SWR-100);
+		#if BARGRAPH_FAST
+		lcdBargraph(BAR_SWR, display_SWR, R.SWR_fullscale*100, 0, 1, 12);
+		#else
 		lcdProgressBar(display_SWR, R.SWR_fullscale*100, 12);
+		#endif
 		#else
 		display_SWR = ((measured_SWR-100) > R.SWR_fullscale*100) ? SWR_FULL_SCALE : (measured_SWR-100);
+		#if BARGRAPH_FAST
+		lcdBargraph(BAR_SWR, display_SWR - 100, SWR_FULL_SCALE, 0, 1, 12);
+		#else
 		lcdProgressBar(display_SWR - 100, SWR_FULL_SCALE, 12);
+		#endif
 		#endif	
 			lcd_putchar_P(PSTR("SWR"));				// Print string from flash rom
 
@@ -1737,7 +1817,7 @@ void lcd_display(void)
 //
 void lcd_display(void)
 {       	
-	#if PWR_PEAK_ENVELOPE							//PEP measurement. Highest value in buffer shown
+	#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 	static uint16_t pow_avg[PEP_MAX_PERIOD];		// Power measurement ringbuffer
 
 	if (R.PEP_samples > PEP_MAX_PERIOD) R.PEP_samples = PEP_MAX_PERIOD;// Safety measure
@@ -1747,6 +1827,9 @@ void lcd_display(void)
 
 	lcd_clrscr();									// Clear Screen is a cheaper operation than
 													// writing blanks, though it causes flicker
+	#if BARGRAPH_FAST
+	lcd_bargraph_redraw();							// Bargraphs cleared
+	#endif
 
 	lcd_command(LCD_DISP_ON);						// Blinking block cursor OFF
 
@@ -1774,7 +1857,7 @@ void lcd_display(void)
 	#endif
 	
 	// Prep Voltage readout.  Max voltage = 15.6V (5V * 14.7k/4.7k)
-	uint16_t vdd_tenths = ((uint32_t) ad7991_adc[AD7991_PSU_VOLTAGE].w * 156) / 0xfff0;
+	uint16_t vdd_tenths = AD7991_VOLT_X10(ad7991_adc[AD7991_PSU_VOLTAGE].w);
 	uint16_t vdd = vdd_tenths / 10;
 	vdd_tenths = vdd_tenths % 10;
 	
@@ -1789,7 +1872,7 @@ void lcd_display(void)
 	if (Status1 & (PA_CAL | TX_FLAG))
 	{
 		// Fetch and normalize PA current
-		uint16_t idd_ca = ad7991_adc[AD7991_PA_CURRENT].w / 262;
+		uint16_t idd_ca = AD7991_AMP_X100(ad7991_adc[AD7991_PA_CURRENT].w);
 		uint16_t idd = idd_ca/100; idd_ca = idd_ca%100;
 	
 		lcd_gotoxy(13,1);							// Second line, 13th position
@@ -1934,9 +2017,13 @@ void lcd_display(void)
 		uint16_t pow_tot, pow, pow_mw;
 
 		// Prepare Power readout
+		#if PWR_PEAK_ENVELOPE && PEP_METER		// PEP from the metering stage, USB Cmd 0x57
+		pow_tot = pep_power;
+		#else
 		pow_tot = measured_Power(ad7991_adc[AD7991_POWER_OUT].w);// Power in mW (max 65535mW)
+		#endif
 
-		#if PWR_PEAK_ENVELOPE						//PEP measurement. Highest value in buffer shown
+		#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 		static uint8_t i = 0;
 
 		#if	PWR_PEP_ADJUST							// Option to adjust the number of samples in PEP measurement
@@ -1963,7 +2050,11 @@ void lcd_display(void)
 		#endif
 
 		// progress, maxprogress, len
+		#if BARGRAPH_FAST
+		lcdBargraph(BAR_PWR, pow_tot/100, R.PWR_fullscale*10, 0, 2, 12);
+		#else
 		lcdProgressBar(pow_tot/100, R.PWR_fullscale*10, 12);
+		#endif
 
 		pow = pow_tot / 1000; 						// Watts
 		pow_mw = pow_tot % 1000;					// milliWatts
@@ -1987,10 +2078,18 @@ void lcd_display(void)
 		#if	BARGRAPH_SWR_SCALE						// Add option to adjust the Fullscale value for the SWR bargraph
 		// possible bug fix for SWR exceeding lcdProgressBar range
 		uint16_t display_SWR = ((measured_SWR-100) > R.SWR_fullscale*100) ? R.SWR_fullscale*100 : (measured_SWR-100);
+		#if BARGRAPH_FAST
+		lcdBargraph(BAR_SWR, display_SWR, R.SWR_fullscale*100, 0, 3, 12);
+		#else
 		lcdProgressBar(display_SWR, R.SWR_fullscale*100, 12);
+		#endif
 		#else
 		display_SWR = ((measured_SWR-100) > R.SWR_fullscale*100) ? SWR_FULL_SCALE : (measured_SWR-100);
+		#if BARGRAPH_FAST
+		lcdBargraph(BAR_SWR, display_SWR - 100, SWR_FULL_SCALE, 0, 3, 12);
+		#else
 		lcdProgressBar(display_SWR - 100, SWR_FULL_SCALE, 12);
+		#endif
 		#endif	
 
 		lcd_putchar_P(PSTR("SWR"));					// Print string from flash rom
@@ -2028,7 +2127,7 @@ void lcd_display(void)
 	//
 	else
 	{
-		#if PWR_PEAK_ENVELOPE						//PEP measurement. Highest value in buffer shown
+		#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 		for (uint8_t j = 0; j < PEP_MAX_PERIOD; j++)// Clear PEP storage during receive
 		{
 			pow_avg[j]=0;
@@ -2080,7 +2179,7 @@ void lcd_display(void)
 //
 void lcd_display(void)
 {       	
-	#if PWR_PEAK_ENVELOPE							//PEP measurement. Highest value in buffer shown
+	#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 	static uint16_t pow_avg[PEP_MAX_PERIOD];		// Power measurement ringbuffer
 
 	if (R.PEP_samples > PEP_MAX_PERIOD) R.PEP_samples = PEP_MAX_PERIOD;// Safety measure
@@ -2090,6 +2189,9 @@ void lcd_display(void)
 
 	lcd_clrscr();									// Clear Screen is a cheaper operation than
 													// writing blanks, though it causes flicker
+	#if BARGRAPH_FAST
+	lcd_bargraph_redraw();							// Bargraphs cleared
+	#endif
 
 	lcd_command(LCD_DISP_ON);						// Blinking block cursor OFF
 
@@ -2117,7 +2219,7 @@ void lcd_display(void)
 	#endif
 	
 	// Prep Voltage readout.  Max voltage = 15.6V (5V * 14.7k/4.7k)
-	uint16_t vdd_tenths = ((uint32_t) ad7991_adc[AD7991_PSU_VOLTAGE].w * 156) / 0xfff0;
+	uint16_t vdd_tenths = AD7991_VOLT_X10(ad7991_adc[AD7991_PSU_VOLTAGE].w);
 	uint16_t vdd = vdd_tenths / 10;
 	vdd_tenths = vdd_tenths % 10;
 	
@@ -2132,7 +2234,7 @@ void lcd_display(void)
 	if (Status1 & (PA_CAL | TX_FLAG))
 	{
 		// Fetch and normalize PA current
-		uint16_t idd_ca = ad7991_adc[AD7991_PA_CURRENT].w / 262;
+		uint16_t idd_ca = AD7991_AMP_X100(ad7991_adc[AD7991_PA_CURRENT].w);
 		uint16_t idd = idd_ca/100; idd_ca = idd_ca % 100;
 	
 		lcd_gotoxy(13,1);							// Second line, 13th position
@@ -2275,9 +2377,13 @@ void lcd_display(void)
 		uint16_t pow_tot, pow, pow_mw;
 
 		// Prepare Power readout
+		#if PWR_PEAK_ENVELOPE && PEP_METER		// PEP from the metering stage, USB Cmd 0x57
+		pow_tot = pep_power;
+		#else
 		pow_tot = measured_Power(ad7991_adc[AD7991_POWER_OUT].w);// Power in mW (max 65535mW)
+		#endif
 
-		#if PWR_PEAK_ENVELOPE						//PEP measurement. Highest value in buffer shown
+		#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 		static uint8_t i = 0;
 
 		#if	PWR_PEP_ADJUST							// Option to adjust the number of samples in PEP measurement
@@ -2304,7 +2410,11 @@ void lcd_display(void)
 		#endif
 
 		// progress, maxprogress, len
+		#if BARGRAPH_FAST
+		lcdBargraph(BAR_PWR, pow_tot/100, R.PWR_fullscale*10, 20, 0, 12);
+		#else
 		lcdProgressBar(pow_tot/100, R.PWR_fullscale*10, 12);
+		#endif
 
 		pow = pow_tot / 1000; 						// Watts
 		pow_mw = pow_tot % 1000;					// milliWatts
@@ -2328,10 +2438,18 @@ void lcd_display(void)
 		#if	BARGRAPH_SWR_SCALE						// Add option to adjust the Fullscale value for the SWR bargraph	
 		// possible bug fix for SWR exceeding lcdProgressBar range
 		uint16_t display_SWR = ((measured_SWR-100) > R.SWR_fullscale*100) ? R.SWR_fullscale*100 : (measured_SWR-100);
+		#if BARGRAPH_FAST
+		lcdBargraph(BAR_SWR, display_SWR, R.SWR_fullscale*100, 20, 1, 12);
+		#else
 		lcdProgressBar(display_SWR, R.SWR_fullscale*100, 12);
+		#endif
 		#else
 		display_SWR = ((measured_SWR-100) > R.SWR_fullscale*100) ? SWR_FULL_SCALE : (measured_SWR-100);
+		#if BARGRAPH_FAST
+		lcdBargraph(BAR_SWR, display_SWR - 100, SWR_FULL_SCALE, 20, 1, 12);
+		#else
 		lcdProgressBar(display_SWR - 100, SWR_FULL_SCALE, 12);
+		#endif
 		#endif	
 		lcd_putchar_P(PSTR("SWR"));					// Print string from flash rom
 
@@ -2368,7 +2486,7 @@ void lcd_display(void)
 	//
 	else
 	{
-		#if PWR_PEAK_ENVELOPE						//PEP measurement. Highest value in buffer shown
+		#if PWR_PEAK_ENVELOPE && !PEP_METER	//PEP measurement. Highest value in buffer shown
 		for (uint8_t j = 0; j < PEP_MAX_PERIOD; j++)// Clear PEP storage during receive
 		{
 			pow_avg[j]=0;
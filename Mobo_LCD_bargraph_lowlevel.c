@@ -224,6 +224,111 @@ void lcdProgressBar(uint16_t progress, uint16_t maxprogress, uint8_t length)
 
 }
 
+#if BARGRAPH_FAST				// Bargraphs drawn by changes
+//
+// lcdProgressBar() works out the bar length with a 32 bit division, and writes
+// all of the bar, on every reading.  lcdBargraph() keeps, for each bar, a scale
+// which is only worked out again when the full scale is changed, and the bar
+// length last drawn, so that only the characters which differ are written.
+//
+// The scale is pixels per unit of progress << 24, rounded up.  The bar length is
+// then the top byte of progress*scale, the same as lcdProgressBar() for a full
+// scale up to 4096.  Above that, it may be one pixel longer right at a pixel step
+//
+#define BARGRAPH_REDRAW			0xff	// Bar length not known, draw all of the bar
+
+typedef struct
+{
+	uint16_t	full;			// Full scale the scale has been worked out for
+	uint32_t	scale;			// Pixels per unit of progress << 24
+	uint8_t		pixels;			// Bar length as drawn, BARGRAPH_REDRAW = not known
+	uint8_t		drawn;			// Drawn since the last lcd_bargraph_frame()
+} bargraph_t;
+
+static bargraph_t bargraph[BARGRAPH_BARS];
+
+// Bargraph character for position i of a bar of the given length in pixels
+static uint8_t bargraph_char(uint8_t i, uint8_t pixels)
+{
+	i = i * PROGRESSPIXELS_PER_CHAR;
+	if (pixels < i) return LCDCHAR_PROGRESS05;		// Empty block
+	pixels = pixels - i;
+	if (pixels > LCDCHAR_PROGRESS55) return LCDCHAR_PROGRESS55;// Full block
+	return pixels;									// Partial block
+}
+
+//
+// Draw bar n at x, y, length characters.  The cursor is left after the bar, as
+// with lcdProgressBar().  The length of a bar must not change
+//
+void lcdBargraph(uint8_t n, uint16_t progress, uint16_t maxprogress, uint8_t x, uint8_t y, uint8_t length)
+{
+	bargraph_t *bar = &bargraph[n];
+	uint8_t pixels, old, i, end;
+
+	if (maxprogress != bar->full)					// New full scale, work out the scale
+	{
+		bar->full = maxprogress;
+		if (maxprogress)
+			bar->scale = (((uint32_t)(length*PROGRESSPIXELS_PER_CHAR) << 24) + maxprogress - 1) / maxprogress;
+		bar->pixels = BARGRAPH_REDRAW;
+	}
+
+	if (progress >= maxprogress)					// Clamp the upper bound
+		pixels = length*PROGRESSPIXELS_PER_CHAR;
+	else
+		pixels = (progress * bar->scale) >> 24;
+
+	old = bar->pixels;
+	bar->pixels = pixels;
+	bar->drawn = True;
+
+	// Characters which may have changed
+	if (old == BARGRAPH_REDRAW)
+	{
+		i = 0;
+		end = length;
+	}
+	else
+	{
+		i = ((pixels < old) ? pixels : old) / PROGRESSPIXELS_PER_CHAR;
+		end = ((pixels > old) ? pixels : old) / PROGRESSPIXELS_PER_CHAR + 1;
+		if (end > length) end = length;
+		while ((i < end) && (bargraph_char(i, pixels) == bargraph_char(i, old))) i++;
+		while ((end > i) && (bargraph_char(end-1, pixels) == bargraph_char(end-1, old))) end--;
+	}
+
+	if (i < end)
+	{
+		lcd_gotoxy(x + i, y);
+		for (; i < end; i++)
+			lcd_data(bargraph_char(i, pixels));
+	}
+	if (end < length)
+		lcd_gotoxy(x + length, y);
+}
+
+//
+// Called at the start of each display pass, before the bars are drawn.  A bar
+// which was not drawn in the last pass has been overwritten by other text
+//
+void lcd_bargraph_frame(void)
+{
+	for (uint8_t n=0; n<BARGRAPH_BARS; n++)
+	{
+		if (!bargraph[n].drawn) bargraph[n].pixels = BARGRAPH_REDRAW;
+		bargraph[n].drawn = False;
+	}
+}
+
+// Called after the LCD is cleared, or the bars are overwritten, in a display pass
+void lcd_bargraph_redraw(void)
+{
+	for (uint8_t n=0; n<BARGRAPH_BARS; n++)
+		bargraph[n].pixels = BARGRAPH_REDRAW;
+}
+#endif
+
 void lcd_bargraph_init(void)
 {
 	// load the first 6 custom characters
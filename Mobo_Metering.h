@@ -0,0 +1,81 @@
+//-----------------------------------------------------------------------------------------
+//			Metering arithmetic, AD7991 readings into V, A and mW
+//
+// No AVR dependencies, so that HostTests/metering_test.c can build and check the same
+// code on a PC.  Included by Mobo.h, the feature flags select the versions used
+//-----------------------------------------------------------------------------------------
+
+#ifndef MOBO_METERING_H
+#define MOBO_METERING_H
+
+#include <stdint.h>
+
+// Conversion of the AD7991 readings (12 bits, MSB aligned, or up to 16 bits with ADC_DECIMATE)
+// for display.  By division, and by multiply and shift with the same results for all 16 bits
+#define AD7991_VOLT_X10_DIV(adc)	(((uint32_t)(adc) * 156) / 0xfff0)	// Full scale = 15.6V (5V * 14.7k/4.7k)
+#define AD7991_AMP_X100_DIV(adc)	((adc) / 262)						// Full scale = 2.5A
+#define AD7991_VOLT_X10_MUL(adc)	(((uint32_t)(adc) * 39946) >> 24)	// Supply voltage in 1/10 V
+#define AD7991_AMP_X100_MUL(adc)	(((uint32_t)(adc) * 16009) >> 22)	// PA current in 1/100 A
+
+#if FAST_METERING
+#define AD7991_VOLT_X10(adc)	AD7991_VOLT_X10_MUL(adc)
+#define AD7991_AMP_X100(adc)	AD7991_AMP_X100_MUL(adc)
+#else
+#define AD7991_VOLT_X10(adc)	AD7991_VOLT_X10_DIV(adc)
+#define AD7991_AMP_X100(adc)	AD7991_AMP_X100_DIV(adc)
+#endif
+
+//
+// FAST_METERING power, P = (v * Cal / 84)^2 / 50000 rewritten as P = m^2, where
+// m = v * Cal / (84 * sqrt(50000)).  m is worked out by one multiply with k, in units
+// of 1/65536, and squared in 16 bit halves.  The result is within 0.56mW of the exact
+// formula, readings above 65535mW saturate.  v is the AD reading, with the same
+// diode offset as the divisions version of measured_Power()
+//
+static inline uint32_t meter_k_of(uint16_t cal)					// m x 65536 per count, in 1/256
+{
+	// 2^24 / (84 * sqrt(50000)) = 893 + 14036/65536
+	return (uint32_t)cal * 893 + (((uint32_t)cal * 14036 + 0x8000) >> 16);
+}
+
+static inline uint16_t meter_v_max_of(uint32_t k)				// Highest count with m below 256
+{
+	uint32_t v_max = 0xffff;
+
+	if (k)
+		v_max = 0xffffff7f / k;									// Rounded product within 32 bits
+	return (v_max > 0xffff) ? 0xffff : v_max;
+}
+
+static inline uint16_t meter_power(uint16_t voltage, uint32_t k, uint16_t v_max)
+{
+	uint32_t m;
+	uint16_t mh, ml;
+
+	if (voltage > 0) voltage = voltage/0x10 + 82;				// Diode offset
+	if (voltage > v_max) return 0xffff;							// Saturate
+	m = ((uint32_t)voltage * k + 0x80) >> 8;					// sqrt(mW) in 1/65536
+	mh = m >> 16;
+	ml = m;
+	// m^2 / 2^32, rounded, from the 16 bit halves of m
+	m = (uint32_t)mh * mh + (((uint32_t)2 * mh * ml + (((uint32_t)ml * ml) >> 16) + 0x8000) >> 16);
+	return (m > 0xffff) ? 0xffff : m;							// Power in mW
+}
+
+//
+// Successive approximation of the highest AD reading which is not above a threshold,
+// above() must never go from true back to false as the reading increases
+//
+static inline uint16_t meter_search(uint8_t (*above)(uint16_t))
+{
+	uint16_t bit, v = 0;
+
+	for (bit = 0x8000; bit; bit >>= 1)
+	{
+		if (!above(v | bit))
+			v |= bit;
+	}
+	return v;
+}
+
+#endif
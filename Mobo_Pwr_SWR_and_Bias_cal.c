@@ -36,13 +36,17 @@
 // Power transmitted,
 // and the global variable ad7991_adc[AD7991_POWER_REF] contains a measurement of the
 // Power reflected,
+#if SWR_ALARM_FUNC												// SWR alarm function, activates a secondary PTT
+static uint8_t swr_timer;										// SWR Alarm patience timer, also
+#endif//SWR_ALARM_FUNC											// seeded by SWR_fast_trip()
+
 void Test_SWR(void)
 {
 
 	uint16_t swr = 100;											// Initialize SWR = 1.0
 
 	#if SWR_ALARM_FUNC											// SWR alarm function, activates a secondary PTT
-	static uint8_t second_pass=0, timer=0;
+	static uint8_t second_pass=0;
 	#endif//SWR_ALARM_FUNC										// SWR alarm function, activates a secondary PTT
 
 	// There is no point in doing a SWR calculation, unless keyed and on the air
@@ -51,23 +55,8 @@ void Test_SWR(void)
 		//-------------------------------------------------------------
 		// Calculate SWR
 		//-------------------------------------------------------------
-		// Quick check for an invalid result 
-		if (ad7991_adc[AD7991_POWER_OUT].w < V_MIN_TRIGGER*0x10)
-			swr = 100;											// Too little for valid measurement, SWR = 1.0
-		else if (ad7991_adc[AD7991_POWER_REF].w >= ad7991_adc[AD7991_POWER_OUT].w)
-			swr = 9990; 										// Infinite (or more than infinite) SWR:
-
-		// Standard SWR formula multiplied by 100, eg 270 = SWR of 2.7
-		else
-		{
-			swr = (uint32_t) 100 * 
-			((uint32_t)ad7991_adc[AD7991_POWER_OUT].w + (uint32_t)ad7991_adc[AD7991_POWER_REF].w)
-				/
-			(uint32_t)(ad7991_adc[AD7991_POWER_OUT].w - ad7991_adc[AD7991_POWER_REF].w);
-		}	
-		if (swr < 9990)											// Set an upper bound to avoid overrrun.
-			measured_SWR = swr;
-		else measured_SWR = 9990;		
+		swr = calc_SWR(ad7991_adc[AD7991_POWER_OUT].w, ad7991_adc[AD7991_POWER_REF].w);
+		measured_SWR = swr;
 
 		#if SWR_ALARM_FUNC										// SWR alarm function, activates a secondary PTT
 		//-------------------------------------------------------------
@@ -77,7 +66,11 @@ void Test_SWR(void)
 		// On measured Power output and high SWR, force clear RXTX2 and seed timer
 
 		// Compare power measured (in mW) with min Trigger value
+		#if FAST_METERING || SWR_FAST_TRIP						// AD reading compared with a
+		if ((ad7991_adc[AD7991_POWER_OUT].w > meter_trigger)	// precalculated threshold
+		#else
 		if ((measured_Power(ad7991_adc[AD7991_POWER_OUT].w) > R.P_Min_Trigger) 	
+		#endif
 
 			&& (measured_SWR > 10*R.SWR_Trigger)) 				// SWR Trigger value is a 10x value,
 																// e.g. 27 corresponds to an SWR of 2.7.
@@ -95,13 +88,13 @@ void Test_SWR(void)
 				MoboPCF_set(Mobo_PCF_TX2);						// Set PTT2 line
 				#endif//REVERSE_PTT2_LOGIC						// end of Switch the PTT2 logic
 				#endif//MOBO_STYLE_IO
-				timer = R.SWR_Protect_Timer;					// Seed SWR Alarm patience timer
+				swr_timer = R.SWR_Protect_Timer;				// Seed SWR Alarm patience timer
 			}
 		}
 		// If SWR OK and timer has been zeroed, set the PTT2 line
 		else 
 		{
-			if (timer == 0)
+			if (swr_timer == 0)
 			{
 				Status1 &= ~SWR_ALARM;							// Clear SWR alarm flag
 				#if MOBO_STYLE_IO
@@ -115,7 +108,7 @@ void Test_SWR(void)
 			}
 			else
 			{
-				timer--;
+				swr_timer--;
 			} 
 		}
 		#endif//SWR_ALARM_FUNC									// SWR alarm function, activates a secondary PTT
@@ -139,6 +132,236 @@ void Test_SWR(void)
 
 
 
+#if SWR_ALARM_FUNC && SWR_FAST_TRIP								// Fast SWR trip, USB Cmd 0x56
+//
+//-----------------------------------------------------------------------------------------
+// 								Fast SWR trip
+//-----------------------------------------------------------------------------------------
+//
+// Called by maintask() on every pass.  During TX, the AD7991 is polled every
+// SWR_TRIP_PERIOD, and the forward and reflected readings compared against the
+// thresholds worked out by meter_update(), without any divisions.  After
+// R.SWR_Trip_Count samples in a row over the threshold, PTT2 is asserted and the
+// bias dropped to class AB at once, as Test_SWR() and PA_bias() do on an SWR alarm.
+// Test_SWR() then holds the alarm for the patience time as usual.
+// The time from the first sample over the threshold is measured, for Cmd 0x56.
+// A poll is 9 bytes of bit banged I2C, the 10ms poll in maintask() uses these
+// readings rather than polling again
+//
+uint8_t		swr_trip_polled;									// Polled since the last 10ms poll
+uint16_t	swr_trip_time;										// Reaction time of the last trip,
+																// in units of 1/62500 s
+uint16_t	swr_trips;											// Number of fast trips
+
+void SWR_fast_trip(void)
+{
+	static uint16_t	last;										// TCNT1 at the last sample
+	static uint16_t	first;										// TCNT1 at the first sample over
+	static uint8_t	count;										// Samples in a row over
+	uint16_t fwd, ref;
+
+	if ((Status1 & (TMP_ALARM | SWR_ALARM)) || !(Status1 & TX_FLAG))
+	{
+		count = 0;
+		return;
+	}
+	if ((uint16_t)(TCNT1 - last) < SWR_TRIP_PERIOD)
+		return;
+	last = TCNT1;
+
+	ad7991_poll(R.AD7991_I2C_addr);
+	swr_trip_polled = 1;
+	#if ADC_DECIMATE											// Only a new value is a new sample,
+	if (!(adc_fresh & (1 << AD7991_POWER_OUT)))					// a held one would be counted again
+		return;
+	adc_fresh &= ~(1 << AD7991_POWER_OUT);
+	#endif
+	fwd = ad7991_adc[AD7991_POWER_OUT].w;
+	ref = ad7991_adc[AD7991_POWER_REF].w;
+
+	// SWR x 100 = 100 * (fwd + ref) / (fwd - ref), compared as
+	// 100 * (fwd + ref) >= (10 x R.SWR_Trigger + 1) * (fwd - ref), same as Test_SWR()
+	if ((fwd <= meter_trigger) || (fwd < V_MIN_TRIGGER*0x10) || !swr_trip_k
+		|| ((ref < fwd) && ((uint32_t)100 * ((uint32_t)fwd + ref) < (uint32_t)swr_trip_k * (fwd - ref))))
+	{
+		count = 0;
+		return;
+	}
+	if (count++ == 0)
+		first = last;
+	if (count < R.SWR_Trip_Count)
+		return;
+
+	count = 0;
+	Status1 |= SWR_ALARM;										// Set SWR alarm flag
+	#if MOBO_STYLE_IO
+	#if  REVERSE_PTT2_LOGIC										// Switch the PTT2 logic
+	MoboPCF_clear(Mobo_PCF_TX2);								// Clear PTT2 line
+	#else//not REVERSE_PTT2_LOGIC								// Normal PTT2 logic
+	MoboPCF_set(Mobo_PCF_TX2);									// Set PTT2 line
+	#endif//REVERSE_PTT2_LOGIC									// end of Switch the PTT2 logic
+	#endif//MOBO_STYLE_IO
+	if (R.Bias_Select == 2)										// Class A, set lower bias setting
+	{
+		ad5301(R.AD5301_I2C_addr, R.cal_LO);
+		biasInit = 0;
+	}
+	swr_timer = R.SWR_Protect_Timer;							// Seed SWR Alarm patience timer
+	swr_trip_time = TCNT1 - first;
+	swr_trips++;
+}
+#endif//SWR_FAST_TRIP
+
+
+//
+//-----------------------------------------------------------------------------------------
+// 				Calculate SWR x 100 from the forward and reflected power readings
+//-----------------------------------------------------------------------------------------
+//
+uint16_t calc_SWR(uint16_t fwd, uint16_t ref)
+{
+	uint32_t swr;
+
+	// Quick check for an invalid result
+	if (fwd < V_MIN_TRIGGER*0x10)
+		return 100;												// Too little for valid measurement, SWR = 1.0
+	if (ref >= fwd)
+		return 9990; 											// Infinite (or more than infinite) SWR:
+
+	// Standard SWR formula multiplied by 100, eg 270 = SWR of 2.7
+	swr = (uint32_t) 100 * ((uint32_t)fwd + (uint32_t)ref) / (uint32_t)(fwd - ref);
+
+	if (swr < 9990)												// Set an upper bound to avoid overrrun.
+		return swr;
+	return 9990;
+}
+
+
+#if SWR_SWEEP													// SWR sweep, USB Cmds 0x4c - 0x4e
+//
+//-----------------------------------------------------------------------------------------
+// 								SWR sweep
+//-----------------------------------------------------------------------------------------
+//
+// Started by USB Cmd 0x4c.  The frequency is set to the first point while the transmitter
+// is released, so that the filters are selected for it, and the transmitter is then kept
+// keyed for the whole sweep.  The following points only retune the Si570, as for any
+// frequency change during TX (FRQ_CGH_DURING_TX).  SWR is measured after the settle time.
+// While the sweep runs, frequency changes by the Encoder, USB commands or the hop list
+// are held off by maintask().
+// The drive level is set by the host software, a low level carrier is all that is needed.
+// The sweep ends on TMP_ALARM or SWR_ALARM (too much drive), or if the PTT is released
+// by anything else than the sweep itself.  At the end, the running frequency is restored
+//
+uint32_t	sweep_freq;											// Frequency of the next point
+uint32_t	sweep_step;											// Frequency step
+uint32_t	sweep_restore;										// Running frequency before the sweep
+uint8_t		sweep_points;										// Number of points in the sweep
+uint8_t		sweep_done;											// Number of points measured
+uint8_t		sweep_settle;										// Settle time after keying, in ms
+uint8_t		sweep_state;										// SWEEP_IDLE, SWEEP_ABORTED, ...
+uint8_t		sweep_swr[SWEEP_POINTS];							// SWR x 10 of each point, 0 = no
+																// valid measurement, 255 = 25.5 or more
+
+static void sweep_ptt(uint8_t tx)								// Key or release the transmitter
+{
+	if (tx)
+	{
+		Status1 |= TX_FLAG;
+		#if MOBO_STYLE_IO
+		MoboPCF_clear(Mobo_PCF_TX);
+		#endif//MOBO_STYLE_IO
+		#if OLDSTYLE_IO
+		IO_PORT_PTT_CWKEY |= IO_PTT;
+		#endif//OLDSTYLE_IO
+	}
+	else
+	{
+		Status1 &= ~TX_FLAG;
+		#if MOBO_STYLE_IO
+		MoboPCF_set(Mobo_PCF_TX);
+		#endif//MOBO_STYLE_IO
+		#if OLDSTYLE_IO
+		IO_PORT_PTT_CWKEY &= ~IO_PTT;
+		#endif//OLDSTYLE_IO
+	}
+}
+
+void SWR_sweep(void)
+{
+	static uint16_t	settle_start;								// TCNT1 when keyed
+	#if ADC_DECIMATE
+	static uint8_t	settled;									// Settle time over, decimating
+	#endif
+	uint16_t swr;
+
+	if (sweep_state < SWEEP_TUNE)								// Not running
+		return;
+
+	// Protections come first.  Also end, if the PTT has been released by a USB command
+	if ((Status1 & (TMP_ALARM | SWR_ALARM))
+		|| (((sweep_state == SWEEP_SETTLE) || sweep_done) && !(Status1 & TX_FLAG)))
+		sweep_state = SWEEP_ABORTED;
+
+	if (sweep_state == SWEEP_TUNE)								// Retune, key at the first point
+	{
+		SetFreq(sweep_freq);
+		if (sweep_done == 0)
+			sweep_ptt(True);
+		settle_start = TCNT1;
+		#if ADC_DECIMATE
+		settled = 0;											// Also after an aborted sweep
+		#endif
+		sweep_state = SWEEP_SETTLE;
+		return;
+	}
+
+	if (sweep_state == SWEEP_SETTLE)							// Measure when settled
+	{
+		#if ADC_DECIMATE										// Start both power sums over once
+		if (!settled)											// settled, no readings from before
+		{														// the retune or during the settle time
+			if ((uint16_t)(TCNT1 - settle_start) < sweep_settle * 125U / 2)// ms -> 1/62500 s
+				return;
+			adc_decimate_restart(AD7991_POWER_OUT);
+			adc_decimate_restart(AD7991_POWER_REF);
+			settled = 1;
+		}
+		ad7991_poll(R.AD7991_I2C_addr);							// Poll until both have a new value
+		if ((adc_fresh & ((1 << AD7991_POWER_OUT) | (1 << AD7991_POWER_REF)))
+			!= ((1 << AD7991_POWER_OUT) | (1 << AD7991_POWER_REF)))
+			return;
+		settled = 0;
+		#else
+		if ((uint16_t)(TCNT1 - settle_start) < sweep_settle * 125U / 2)// ms -> 1/62500 s
+			return;
+
+		ad7991_poll(R.AD7991_I2C_addr);
+		#endif
+		if (ad7991_adc[AD7991_POWER_OUT].w < V_MIN_TRIGGER*0x10)
+			swr = 0;											// Too little for a valid measurement
+		else
+			swr = calc_SWR(ad7991_adc[AD7991_POWER_OUT].w, ad7991_adc[AD7991_POWER_REF].w) / 10;
+		sweep_swr[sweep_done] = (swr > 255) ? 255 : swr;
+
+		sweep_freq += sweep_step;
+		if (++sweep_done < sweep_points)
+		{
+			sweep_state = SWEEP_TUNE;
+			return;
+		}
+		sweep_state = SWEEP_IDLE;								// Completed
+	}
+	else if (sweep_state == SWEEP_STOP)							// Stopped by Cmd 0x4d
+		sweep_state = SWEEP_IDLE;
+
+	// Sweep ended, release the transmitter and restore the frequency
+	sweep_ptt(False);
+	SetFreq(sweep_restore);
+}
+#endif//SWR_SWEEP
+
+
 //
 //-----------------------------------------------------------------------------------------
 // 				Convert AD reading into "Measured Power in milliWatts"
@@ -149,6 +372,158 @@ void Test_SWR(void)
 // (the return value overflows above 65W max)
 // (comparison Ref 11604 bytes)
 
+#if PWR_CAL_TABLE												// Power calibration table, USB Cmds 0x4f, 0x5a, 0x5b
+//
+// With a table of at least 2 points loaded for the band in use, the power is interpolated
+// between the two points either side of the AD reading, found by binary search, rather than
+// worked out by the formula below.  Below the first point the power of the first point is
+// returned, above the last point the last two points are extended.  A band table is
+// selected by the TX filter in use, the highest band table is used for any higher filter.
+// The power of a point is stored with 12 significant bits, (mW & 0xfff) << exponent, to
+// fit 16 bits.  The band table in use is copied into RAM, with the slope from each point
+// to the next, in the same format in units of 1/16384 mW per count, so that a reading
+// takes one multiply and one shift.  The slope is rounded to 12 significant bits, or to
+// 1/32768 mW per count, and saturates at 8190 mW per count.  The reading is within 1/2048
+// of the rise from the point below, plus 3mW, of the exact interpolation
+//
+EEMEM pwr_cal_t	E_PwrCal[PWR_CAL_BANDS][PWR_CAL_POINTS];		// Band tables
+
+uint8_t		pwr_cal_band = 0xff;								// Band table in use, 0xff = none
+static uint8_t	pwr_cal_n;										// Points in the band table in use
+static struct
+{
+	pwr_cal_t	p;												// Point, as in EEPROM
+	uint16_t	slope;											// To the next point, packed
+} pwr_cal[PWR_CAL_POINTS];										// Band table in use
+
+uint16_t pwr_cal_pack(uint32_t mw)
+{
+	uint8_t e = 0;
+
+	while (mw > 0xfff)
+	{
+		if (e == 15) return 0xffff;								// Over 134kW, saturate
+		mw = (mw >> 1) + (mw & 1);								// Rounded
+		e++;
+	}
+	return ((uint16_t)e << 12) | mw;
+}
+
+uint32_t pwr_cal_unpack(uint16_t mw)
+{
+	return (uint32_t)(mw & 0xfff) << (mw >> 12);
+}
+
+void pwr_cal_reload(void)										// Work out the slopes of the band
+{																// table in use, with the divisions
+	uint8_t i;
+	uint16_t span;
+	uint32_t p0, d, s;
+
+	pwr_cal_n = (pwr_cal_band < PWR_CAL_BANDS) ? R.PWR_Cal_Points[pwr_cal_band] : 0;
+	if (pwr_cal_n > PWR_CAL_POINTS) pwr_cal_n = PWR_CAL_POINTS;
+
+	for (i = 0; i + 1 < pwr_cal_n; i++)
+	{
+		p0 = pwr_cal_unpack(pwr_cal[i].p.mw);
+		d = pwr_cal_unpack(pwr_cal[i+1].p.mw);
+		span = pwr_cal[i+1].p.adc - pwr_cal[i].p.adc;
+		if ((pwr_cal[i+1].p.adc <= pwr_cal[i].p.adc) || (d <= p0))
+			s = 0;												// Points out of order, flat
+		else
+		{
+			// (p1 - p0) x 16384 / span, rounded.  The remainder part can not overflow,
+			// any whole part over 18 bits is far above the highest slope that can be packed
+			d -= p0;
+			s = d / span;
+			d = d % span;
+			s = (s >> 18) ? 0xffffffff : (s << 14) + (((d << 14) + span/2) / span);
+		}
+		pwr_cal[i].slope = pwr_cal_pack(s);
+	}
+	#if FAST_METERING || SWR_FAST_TRIP
+	meter_update();												// The trigger follows the table
+	#endif
+}
+
+void pwr_cal_point(uint8_t band, uint8_t i, pwr_cal_t *p)		// Point loaded by Cmd 0x4f, R has
+{																// the new number of points
+	if (band == pwr_cal_band)									// Into the table in use too, the
+		pwr_cal[i].p = *p;										// EEPROM write may be deferred
+	pwr_cal_reload();
+}
+
+void pwr_cal_update(void)										// Called by maintask() every 10ms
+{
+	uint8_t i, band = selectedFilters[1];
+
+	if (band >= PWR_CAL_BANDS) band = PWR_CAL_BANDS - 1;
+	if (band == pwr_cal_band) return;
+
+	pwr_cal_band = band;
+	for (i = 0; i < PWR_CAL_POINTS; i++)
+		eeprom_read_block(&pwr_cal[i].p, &E_PwrCal[band][i], sizeof(pwr_cal_t));
+	pwr_cal_reload();
+}
+
+uint32_t cal_Power(uint16_t voltage)
+{
+	uint8_t lo, hi, mid, e;
+	uint16_t s;
+	uint32_t q;
+
+	if (pwr_cal_n < 2)											// No table, use the formula
+		return measured_Power(voltage);
+
+	// Find the points either side, the last two also cover readings above the table
+	lo = 0;
+	hi = pwr_cal_n - 1;
+	while (hi - lo > 1)
+	{
+		mid = (lo + hi) / 2;
+		if (voltage >= pwr_cal[mid].p.adc)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	if (voltage <= pwr_cal[lo].p.adc)							// Below the table
+		return pwr_cal_unpack(pwr_cal[lo].p.mw);
+
+	// p0 + slope * x.  x * mantissa is within 28 bits, shifted left by at most 1,
+	// and p0 is within 27 bits, no overflow
+	s = pwr_cal[lo].slope;
+	e = s >> 12;
+	q = (uint32_t)(voltage - pwr_cal[lo].p.adc) * (s & 0xfff);
+	q = (e >= 14) ? q << (e - 14) : q >> (14 - e);
+	return pwr_cal_unpack(pwr_cal[lo].p.mw) + q;
+}
+#endif//PWR_CAL_TABLE
+
+
+#if FAST_METERING												// Multiply and shift metering
+//
+// The formula below, P = (v * R.PWR_Calibrate / 84)^2 / 50000, by meter_power() in
+// Mobo_Metering.h.  Within 0.56mW of the exact formula, the divisions below truncate
+// and are up to 3mW off.  Readings above 65535mW saturate.
+// The constants are worked out by meter_update(), whenever R.PWR_Calibrate is changed.
+// HostTests/metering_test.c checks Mobo_Metering.h against the exact formula
+//
+uint32_t	meter_k;											// m x 65536 per count, in 1/256
+uint16_t	meter_v_max;										// Highest count with m below 256
+
+uint16_t measured_Power(uint16_t voltage)
+{
+	#if PWR_CAL_TABLE											// Calibration table for the band
+	if (pwr_cal_n >= 2)
+	{
+		uint32_t p = cal_Power(voltage);
+		return (p > 0xffff) ? 0xffff : p;
+	}
+	#endif
+
+	return meter_power(voltage, meter_k, meter_v_max);			// Return power in mW
+}
+#else
 uint16_t measured_Power(uint16_t voltage)
 {
 	// All standard stuff
@@ -158,6 +533,14 @@ uint16_t measured_Power(uint16_t voltage)
 	// R.PWR_Calibrate = Power meter calibration value
 	uint32_t measured_P; 
 	
+	#if PWR_CAL_TABLE											// Calibration table for the band
+	if (pwr_cal_n >= 2)
+	{
+		measured_P = cal_Power(voltage);
+		return (measured_P > 0xffff) ? 0xffff : measured_P;
+	}
+	#endif
+
 	if (voltage > 0) voltage = voltage/0x10 + 82;				// If no input voltage, then we do not add offset voltage
 																// as this would otherwise result in a bogus minimum power
 																// reading
@@ -170,10 +553,274 @@ uint16_t measured_Power(uint16_t voltage)
 	measured_P = (measured_P*measured_P)/50000;
 	return (uint16_t) measured_P;								// Return power in mW
 }
+#endif//FAST_METERING
+
+
+#if FAST_METERING || SWR_FAST_TRIP
+//
+//-----------------------------------------------------------------------------------------
+// 		Work out the metering constants, whenever the calibration or triggers are changed
+//-----------------------------------------------------------------------------------------
+//
+uint16_t	meter_trigger;										// Highest AD reading which is not
+																// above R.P_Min_Trigger
+#if SWR_FAST_TRIP
+uint16_t	swr_trip_k;											// 10 x R.SWR_Trigger + 1, 0 = off
+#endif
+
+static uint8_t meter_above_trigger(uint16_t voltage)			// Power over R.P_Min_Trigger
+{
+	#if !FAST_METERING
+	#if PWR_CAL_TABLE
+	if (pwr_cal_n < 2)
+	#endif
+	{
+		// The formula of measured_Power(), with the square compared in 32 bits, as
+		// the 16 bit result overflows above 65W.  p^2 / 50000 <= P_Min_Trigger is
+		// p^2 < 50000 x (P_Min_Trigger + 1), and any p above 16 bits is over that
+		uint32_t p;
+
+		if (voltage > 0) voltage = voltage/0x10 + 82;
+		p = (uint32_t)voltage * R.PWR_Calibrate/84;
+		return (p > 0xffff) || (p * p >= (uint32_t)50000 * (R.P_Min_Trigger + 1));
+	}
+	#endif
+	return measured_Power(voltage) > R.P_Min_Trigger;
+}
+
+void meter_update(void)
+{
+	#if FAST_METERING
+	meter_k = meter_k_of(R.PWR_Calibrate);
+	meter_v_max = meter_v_max_of(meter_k);
+	#endif
+
+	// The AD reading where the power passes P_Min_Trigger, so that the SWR alarm
+	// can compare the AD reading without working out the power
+	meter_trigger = meter_search(meter_above_trigger);
+
+	#if SWR_FAST_TRIP
+	// calc_SWR() is capped at 9990, a higher trigger can never be reached
+	swr_trip_k = (R.SWR_Trigger < 999) ? 10 * R.SWR_Trigger + 1 : 0;
+	#endif
+}
+#endif
+
+
+#if PEP_METER													// PEP, average and peak hold, USB Cmd 0x57
+//
+//-----------------------------------------------------------------------------------------
+// 				PEP, average and peak hold power metering
+//-----------------------------------------------------------------------------------------
+//
+// Called with every 10ms AD7991 reading.  The readings are grouped in 100ms buckets, and
+// PEP is the highest reading within the current bucket and the R.PEP_samples - 1 before it,
+// a window of 1 shows the highest reading since the start of the current 100ms.
+// The bucket maxima are kept in a monotonic queue, each new one drops the lower ones
+// before it, so that the head of the queue is always the highest within the window.
+// Each bucket is added and dropped once, the cost per reading is constant, whatever
+// the length of the window.  measured_Power() never decreases with the AD reading,
+// the queue is kept in AD readings and only the result is converted into mW
+//
+typedef struct
+{
+	uint16_t	adc;											// Highest reading in the bucket
+	uint8_t		seq;											// Bucket number
+} pep_t;
+
+static pep_t	pep_q[PEP_MAX_PERIOD];							// Monotonic queue of bucket maxima
+static uint8_t	pep_head;										// Oldest and highest entry
+static uint8_t	pep_len;										// Entries in the queue
+static uint8_t	pep_seq;										// Number of the current bucket
+static uint8_t	pep_count;										// Readings in the current bucket
+static uint16_t	pep_max;										// Highest reading in the current bucket
+static uint32_t	pep_sum;										// Average x 2^PEP_AVG_SHIFT
+
+uint16_t	pep_power;											// PEP in mW
+uint16_t	pep_hold;											// Peak hold in mW, cleared by Cmd 0x57
+
+void pep_update(void)
+{
+	uint16_t adc = ad7991_adc[AD7991_POWER_OUT].w;
+	uint16_t p;
+	uint8_t window, i;
+
+	if (!(Status1 & TX_FLAG))									// Clear PEP and average during receive
+	{
+		pep_len = pep_count = 0;
+		pep_max = pep_power = 0;
+		pep_sum = 0;
+		return;
+	}
+
+	p = measured_Power(adc);
+	pep_sum += p - (pep_sum >> PEP_AVG_SHIFT);
+	if (p > pep_hold) pep_hold = p;
+	if (adc > pep_max) pep_max = adc;
+
+	if (++pep_count >= PEP_BUCKET)								// Bucket full, queue it
+	{
+		#if	PWR_PEP_ADJUST										// Window adjustable through USB Cmd 0x66
+		window = R.PEP_samples;
+		if (window > PEP_MAX_PERIOD) window = PEP_MAX_PERIOD;
+		if (window == 0) window = 1;
+		#else
+		window = PEP_PERIOD;
+		#endif
+
+		// Drop the lower entries at the tail, they can never be the highest again
+		while (pep_len)
+		{
+			i = pep_head + pep_len - 1;
+			if (i >= PEP_MAX_PERIOD) i -= PEP_MAX_PERIOD;
+			if (pep_q[i].adc > pep_max) break;
+			pep_len--;
+		}
+		i = pep_head + pep_len;
+		if (i >= PEP_MAX_PERIOD) i -= PEP_MAX_PERIOD;
+		pep_q[i].adc = pep_max;
+		pep_q[i].seq = pep_seq;
+		pep_len++;
+
+		// Drop the entries at the head, which have gone out of the window
+		pep_seq++;
+		while (pep_len && ((uint8_t)(pep_seq - pep_q[pep_head].seq) >= window))
+		{
+			if (++pep_head >= PEP_MAX_PERIOD) pep_head = 0;
+			pep_len--;
+		}
+		pep_count = 0;
+		pep_max = 0;
+	}
+
+	adc = pep_max;
+	if (pep_len && (pep_q[pep_head].adc > adc)) adc = pep_q[pep_head].adc;
+	pep_power = measured_Power(adc);
+}
+
+uint16_t pep_average(void)
+{
+	return pep_sum >> PEP_AVG_SHIFT;
+}
+#endif//PEP_METER
 #endif//POWER_SWR												// Power and SWR measurement
 
 
 
+#if BIAS_FAST_CAL												// Fast PA bias calibration, USB Cmd 0x58
+//
+//-----------------------------------------------------------------------------------------
+// 						RD16HHF1 PA Bias calibration, successive approximation
+//-----------------------------------------------------------------------------------------
+//
+// For each of R.Bias_LO and R.Bias_HI, the lowest bias setting which gives at least that
+// PA current is found by a binary search over 0 - 255, 256 meaning not reached.  Each
+// reading narrows both searches, so that the class A search starts where the class AB
+// search left it.  At most 9 readings per search, each after R.Bias_Settle x 10ms.
+// The results are written to EEPROM once, at the end
+//
+uint8_t		bias_cal_status;									// BIAS_CAL_IDLE, BIAS_CAL_RUN, ...
+uint8_t		bias_cal_steps;										// Bias readings taken
+uint8_t		bias_cal_probe;										// Bias setting being measured
+uint8_t		bias_cal_current;									// Last PA current reading
+
+static uint16_t	bias_cal_lo[2];									// Lowest possible setting, LO and HI
+static uint16_t	bias_cal_hi[2];									// Lowest setting known to be enough
+static uint8_t	bias_cal_wait;									// 10ms ticks left to settle
+
+static void bias_calibrate(void)
+{
+	uint8_t k, target;
+
+	if (!(Status1 & PA_CAL))									// Start
+	{
+		Status1 |= TX_FLAG | PA_CAL;							// Set a couple of progress flags
+
+		// Switch to Transmit mode, set TX out
+		#if MOBO_STYLE_IO
+		MoboPCF_clear(Mobo_PCF_TX);
+		#endif//MOBO_STYLE_IO
+		#if OLDSTYLE_IO
+		IO_PORT_PTT_CWKEY |= IO_PTT;
+		#endif//OLDSTYLE_IO
+
+		bias_cal_lo[0] = bias_cal_lo[1] = 0;
+		bias_cal_hi[0] = bias_cal_hi[1] = 256;
+		bias_cal_steps = 0;
+		bias_cal_status = BIAS_CAL_RUN;
+	}
+	else
+	{
+		if (--bias_cal_wait)									// Not settled yet
+			return;
+		#if ADC_DECIMATE										// Wait for a value made after the step
+		if (!(adc_fresh & (1 << AD7991_PA_CURRENT)))
+		{
+			bias_cal_wait = 1;
+			return;
+		}
+		#endif
+
+		// Narrow both searches with the new reading
+		bias_cal_current = ad7991_adc[AD7991_PA_CURRENT].b1;
+		bias_cal_steps++;
+		for (k = 0; k < 2; k++)
+		{
+			if ((bias_cal_probe < bias_cal_lo[k]) || (bias_cal_probe >= bias_cal_hi[k]))
+				continue;										// Known already
+			target = k ? R.Bias_HI : R.Bias_LO;
+			if (bias_cal_current >= target)
+				bias_cal_hi[k] = bias_cal_probe;
+			else
+				bias_cal_lo[k] = bias_cal_probe + 1;
+		}
+	}
+
+	// Next reading, class AB first
+	k = (bias_cal_lo[0] < bias_cal_hi[0]) ? 0 : 1;
+	if (bias_cal_lo[k] < bias_cal_hi[k])
+	{
+		bias_cal_probe = (bias_cal_lo[k] + bias_cal_hi[k]) / 2;
+		ad5301(R.AD5301_I2C_addr, bias_cal_probe);
+		#if ADC_DECIMATE										// No readings from before the step
+		adc_decimate_restart(AD7991_PA_CURRENT);
+		#endif
+		bias_cal_wait = R.Bias_Settle ? R.Bias_Settle : 1;
+		return;
+	}
+
+	// Done, both searches have ended
+	if ((bias_cal_hi[0] > 0xff) || (bias_cal_hi[1] > 0xff))
+	{
+		R.cal_HI = R.cal_LO = 0;								// We have no valid bias setting
+		bias_cal_status = BIAS_CAL_FAILED;
+	}
+	else
+	{
+		R.cal_LO = bias_cal_hi[0];
+		R.cal_HI = bias_cal_hi[1];
+		bias_cal_status = BIAS_CAL_DONE;
+	}
+
+	Status1 &= ~(PA_CAL_LO | PA_CAL_HI | PA_CAL | TX_FLAG );	// We're done, Clear all flags
+
+	// Swtich back to Receive mode, key the TX down
+	#if MOBO_STYLE_IO
+	MoboPCF_set(Mobo_PCF_TX);
+	#endif//MOBO_STYLE_IO
+	#if OLDSTYLE_IO
+	IO_PORT_PTT_CWKEY &= ~IO_PTT;
+	#endif//OLDSTYLE_IO
+
+	R.Bias_Select = 2;											// Set bias select for class A
+	biasInit = 0;												// Ensure that the class A bias is set
+	eeprom_write_block(&R.cal_LO, &E.cal_LO, sizeof (uint8_t));
+	eeprom_write_block(&R.cal_HI, &E.cal_HI, sizeof (uint8_t));
+	eeprom_write_block(&R.Bias_Select, &E.Bias_Select, sizeof (uint8_t));
+}
+#endif//BIAS_FAST_CAL
+
+
 //
 //-----------------------------------------------------------------------------------------
 // 								RD16HHF1 PA Bias management
@@ -183,7 +830,9 @@ void PA_bias(void)
 
 
 {
+	#if !BIAS_FAST_CAL
 	uint8_t static calibrate = 0;								// Current calibrate value
+	#endif
 
 	switch (R.Bias_Select)
 	{
@@ -214,6 +863,10 @@ void PA_bias(void)
 		// Calibrate RD16HHF1 Bias 
 		//-------------------------------------------------------------
 		default:												// Calibrate RD16HHF1 PA bias
+			#if BIAS_FAST_CAL									// Successive approximation
+			if (!(Status1 & TMP_ALARM))							// Proceed if there are no inhibits
+				bias_calibrate();
+			#else
 			if (!(Status1 & TMP_ALARM))							// Proceed if there are no inhibits
 			{
 				Status1 |= TX_FLAG | PA_CAL;					// Set a couple of progress flags
@@ -226,6 +879,11 @@ void PA_bias(void)
 				IO_PORT_PTT_CWKEY |= IO_PTT;
 				#endif//OLDSTYLE_IO
 
+				#if ADC_DECIMATE								// Wait for a value made after the step
+				if (!(adc_fresh & (1 << AD7991_PA_CURRENT)))
+					break;
+				#endif
+
 				// Is current larger or equal to setpoint for class AB?
 				if((ad7991_adc[AD7991_PA_CURRENT].b1 >= R.Bias_LO) && !(Status1 & PA_CAL_LO))
 				{
@@ -277,8 +935,132 @@ void PA_bias(void)
 				{
 					calibrate++;								// Crank up the bias by one notch
 					ad5301(R.AD5301_I2C_addr, calibrate);		// for the next round of measurements
+					#if ADC_DECIMATE							// No readings from before the step
+					adc_decimate_restart(AD7991_PA_CURRENT);
+					#endif
 				}
 			}
+			#endif//BIAS_FAST_CAL
 	}
 }
 
+
+
+#if TR_SEQUENCER												// T/R sequencer, USB Cmds 0x54 and 0x55
+//
+//-----------------------------------------------------------------------------------------
+// 								T/R sequencer
+//-----------------------------------------------------------------------------------------
+//
+// A PTT change from Cmd 0x50 (or the keyer) is done as a sequence of steps, RX mute,
+// antenna relay, PTT, PA bias and PTT2 for TX, and the reverse for RX, each after its own
+// delay.  tr_pos counts the TX steps in effect, and is stepped towards tr_target.
+// If the PTT is changed during a sequence, then the sequence turns back from where it is.
+// Steps which fall due at the same time are batched, the Mobo PCF8574 is written once.
+// The time from the PTT change to the last step is measured, and returned by Cmd 0x55
+//
+uint8_t		tr_pos;												// Number of TX steps in effect
+uint8_t		tr_target;											// TR_STEPS for TX, 0 for RX
+uint16_t	tr_measured[2];										// Duration of the last TX and
+																// RX sequences, in 1/62500 s
+static uint16_t	tr_start;										// TCNT1 at the PTT change
+static uint16_t	tr_due;											// TCNT1 when the next step is due
+
+static void tr_next(void)										// Time the next step
+{
+	uint8_t delay = tr_target ? R.TR_Seq[tr_pos] : R.TR_Seq[TR_RX_DELAY + tr_pos - 1];
+	tr_due = TCNT1 + delay * 125U / 2;							// ms -> 1/62500 s
+}
+
+void tr_ptt(uint8_t tx)											// Start a TX or RX sequence
+{
+	if (tx)
+	{
+		Status1 |= TX_FLAG;										// Set the TX flag
+		if ((Status1 & (TMP_ALARM | PA_CAL)) || tr_target)		// Inhibited, or already TX
+			return;
+		tr_target = TR_STEPS;
+	}
+	else
+	{
+		Status1 &= ~TX_FLAG;									// Clear the TX flag
+		if (!tr_target)
+			return;
+		tr_target = 0;
+	}
+	tr_start = TCNT1;
+	if (tr_pos != tr_target)
+		tr_next();
+}
+
+uint8_t tr_sequence(void)										// Do the steps which are due,
+{																// returns True while in progress
+	uint8_t pcf = pcf_data_out;
+	uint8_t busy = (tr_pos != tr_target);
+	uint8_t tx = tr_target;
+	uint8_t step;
+
+	while ((tr_pos != tr_target) && ((int16_t)(TCNT1 - tr_due) >= 0))
+	{
+		step = tx ? tr_pos++ : --tr_pos;
+		switch (step)
+		{
+			case TR_MUTE:
+				pcf = tx ? pcf & ~R.TR_Seq[TR_MUTE_BITS] : pcf | R.TR_Seq[TR_MUTE_BITS];
+				break;
+			case TR_ANT:
+				pcf = tx ? pcf & ~R.TR_Seq[TR_ANT_BITS] : pcf | R.TR_Seq[TR_ANT_BITS];
+				break;
+			case TR_PTT:
+				#if MOBO_STYLE_IO
+				pcf = tx ? pcf & ~Mobo_PCF_TX : pcf | Mobo_PCF_TX;
+				#endif//MOBO_STYLE_IO
+				#if OLDSTYLE_IO
+				if (tx) IO_PORT_PTT_CWKEY |= IO_PTT;
+				else IO_PORT_PTT_CWKEY &= ~IO_PTT;
+				#endif//OLDSTYLE_IO
+				break;
+			case TR_BIAS:												// Select the stored bias, a
+				if (tx && ((R.Bias_Select == 1) || (R.Bias_Select == 2)))// T/R change never starts
+				{														// a bias calibration
+					#if MOBO_STYLE_IO
+					if (pcf != pcf_data_out)							// Keep the order, write out
+					{													// the steps so far first
+						pcf_data_out = pcf;
+						pcf8574_byte(R.PCF_I2C_Mobo_addr, pcf);
+					}
+					#endif//MOBO_STYLE_IO
+					biasInit = 0;										// Ensure that the stored bias
+					PA_bias();											// is set
+				}
+				break;
+			#if POWER_SWR && SWR_ALARM_FUNC && MOBO_STYLE_IO
+			case TR_PTT2:												// PTT2 released for TX, and
+				#if  REVERSE_PTT2_LOGIC									// then managed by Test_SWR()
+				pcf = tx ? pcf | Mobo_PCF_TX2 : pcf & ~Mobo_PCF_TX2;
+				#else//not REVERSE_PTT2_LOGIC
+				pcf = tx ? pcf & ~Mobo_PCF_TX2 : pcf | Mobo_PCF_TX2;
+				#endif//REVERSE_PTT2_LOGIC
+				break;
+			#endif
+		}
+		if (tr_pos != tr_target)
+			tr_next();
+	}
+
+	#if MOBO_STYLE_IO
+	if (pcf != pcf_data_out)									// One write for all steps done
+	{
+		pcf_data_out = pcf;
+		pcf8574_byte(R.PCF_I2C_Mobo_addr, pcf);
+	}
+	#endif//MOBO_STYLE_IO
+
+	if (busy && (tr_pos == tr_target))							// Done, measure
+	{
+		tr_measured[tx ? 0 : 1] = TCNT1 - tr_start;
+		busy = False;
+	}
+	return busy;
+}
+#endif//TR_SEQUENCER
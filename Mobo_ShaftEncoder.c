@@ -27,9 +27,12 @@
 //**                   2009-09-08, Loftur Jonasson, TF3LJ
 //**
 //** Update..........: Variable Speed VFO.  2009-09-22, Loftur Jonasson, TF3LJ
-//** Last update.....: User Cmd for Encoder Resolution (resolvable states per revolution)  
+//** Update..........: User Cmd for Encoder Resolution (resolvable states per revolution)  
 //**                   2010-04-11, Loftur Jonasson, TF3LJ
 //**
+//** Last update.....: Optional table driven decoder for the Interrupt driven Encoder,
+//**                   interrupts on both phases for full resolution.  2026-10-19
+//**
 //*********************************************************************************
 
 
@@ -40,6 +43,46 @@
 #include <avr/io.h>
 #include <avr/interrupt.h>
 
+#if ENCODER_INT_TABLE							// Interrupt on both phases, table driven decoder
+//
+// Quadrature decoder state transition table.  Indexed by the previous state of
+// the two phases in bits 3:2 and the current state in bits 1:0 (Phase A = bit 1,
+// Phase B = bit 0).  A change on both phases at once is an invalid transition.
+//
+const int8_t enc_table[16] PROGMEM =
+{
+	0,			-1,			+1,			ENC_INVALID,	// 00 -> 00, 01, 10, 11
+	+1,			0,			ENC_INVALID,-1,				// 01 -> 00, 01, 10, 11
+	-1,			ENC_INVALID,0,			+1,				// 10 -> 00, 01, 10, 11
+	ENC_INVALID,+1,			-1,			0				// 11 -> 00, 01, 10, 11
+};
+
+static uint8_t	enc_state;						// Previous and current state of the two phases
+uint16_t		enc_invalid;					// Number of invalid transitions (read by Cmd 0x69)
+#endif
+
+static volatile int16_t		enc_ticks;			// Encoder ticks accumulated by the interrupt handler
+#if ENCODER_FAST_ENABLE || ENCODER_ACCEL		// Variable speed Rotary Encoder feature
+static volatile uint16_t	enc_ticktime;		// Time of the last encoder pulse, from TCNT1
+#endif
+#if ENCODER_FAST_RETUNE							// Write encoder frequency changes without delay
+static volatile uint16_t	enc_firsttime;		// Time of the first accumulated encoder pulse
+static uint16_t	enc_pending;					// Time of the first pulse not yet written to the Si570
+static uint8_t	enc_is_pending;					// Set while a pulse is not yet written to the Si570
+uint16_t		enc_latency[2];					// Last and max latency (read by Cmd 0x69)
+#endif
+
+#if ENCODER_RESOLUTION
+// Scaling constants, derived from R.Resolvable_States by encoder_resolution_update()
+#if !ENCODER_CMD_INCR
+static uint16_t	encoder_resolution = 8388/ENC_PULSES;
+#endif
+#if ENCODER_FAST_ENABLE
+static uint16_t	enc_fast_sense = ENC_FAST_SENSE;
+static uint16_t	enc_fast_trig = ENC_FAST_TRIG;
+#endif
+#endif
+
 //
 // Init Encoder and Interrupt for use
 //
@@ -65,6 +108,20 @@ void shaftEncoderInit(void)
 	// Enable interrupt vector
 	ENC_A_IREG |= ENC_A_INT;
 
+	#if ENCODER_INT_TABLE						// Interrupt on both phases, table driven decoder
+	// Start the decoder from the current state of the two phases
+	if (ENC_A_PORTIN & ENC_A_PIN) enc_state |= 0x02;
+	if (ENC_B_PORTIN & ENC_B_PIN) enc_state |= 0x01;
+
+	// Enable pin change interrupt for Phase B
+	ENC_B_PCMSK |= ENC_B_PCINT;
+	PCICR |= ENC_B_PCIE;
+	#endif
+
+	#if ENCODER_RESOLUTION
+	encoder_resolution_update();				// Scaling constants from the stored resolution
+	#endif
+
 	sei();
 }
 
@@ -72,70 +129,169 @@ void shaftEncoderInit(void)
 // Shaft Encoder interrupt handler
 // PCINT could be used as a substitute for INT.  Would need a revision of
 // the Interrupt init above.
+// With ENCODER_INT_TABLE, Phase B pin change interrupt shares the same handler.
+// The handler only accumulates encoder ticks and a timestamp.  Scaling,
+// variable speed and the VFO frequency update are done in encoder_update(),
+// called from the mainloop.
 //
+#if ENCODER_INT_TABLE							// Interrupt on both phases, table driven decoder
+ISR_ALIAS(ENC_B_SIGNAL, ENC_A_SIGNAL);
+#endif
+
 ISR(ENC_A_SIGNAL)
 {
-	int8_t	increment = 0;						// This interim variable used to add up changes
-												// rather than enacting them directly on the
-												// uint32_t variable which contains the frequency
-												// this saves a bunch of bytes
+	#if ENCODER_INT_TABLE						// Interrupt on both phases, table driven decoder
+	int8_t	increment;
 
-	#if ENCODER_FAST_ENABLE						// Variable speed Rotary Encoder feature
-	uint16_t		enc_time;					// Read and use time from TCNT1
-	static uint16_t	enc_last;					// Measure the time elapsed since the last encoder pulse
-	static uint8_t	fast_counter=0;				// Number of rapid movements in succession
-	#if ENCODER_DIR_SENSE						// Direction change sense.  Used with variable speed feature.
-	static int8_t	direction;					// Direction of last encoder pulse
-	#endif
-	#endif
+	// Look up the transition from the previous to the current state of the two phases
+	enc_state = (enc_state << 2) & 0x0f;		// Previous state into bits 3:2
+	if (ENC_A_PORTIN & ENC_A_PIN) enc_state |= 0x02;
+	if (ENC_B_PORTIN & ENC_B_PIN) enc_state |= 0x01;
 
-	#if ENCODER_RESOLUTION
-	uint16_t enc_fast_sense = ENC_FAST_SENSE;
-	uint16_t enc_fast_trig = ENC_FAST_TRIG;
-	#if !ENCODER_CMD_INCR
-	uint16_t encoder_resolution = 8388/ENC_PULSES;
-	encoder_resolution = 8388/R.Resolvable_States;
-	enc_fast_sense = 96000/R.Resolvable_States;
-	enc_fast_trig = R.Resolvable_States/5;
-	#else
-	if(!(Status2 & ENC_RES))					// If resolution has not been modified by Cmd 0x36
+	increment = pgm_read_byte(&enc_table[enc_state]);
+	if (increment == ENC_INVALID)				// Both phases changed, a pulse was missed
 	{
-		#if ENCODER_CMD_INCR
-		R.Encoder_Resolution = 8388/R.Resolvable_States;
-		#else
-		encoder_resolution = 8388/R.Resolvable_States;
-		#endif
-		enc_fast_sense = 96000/R.Resolvable_States;
-		enc_fast_trig = R.Resolvable_States/5;
+		enc_invalid++;
+		return;
 	}
+	if (increment == 0) return;					// No change, contact bounce
+	#if ENCODER_FAST_RETUNE						// Write encoder frequency changes without delay
+	if (enc_ticks == 0) enc_firsttime = TCNT1;
 	#endif
-	#endif
-
+	enc_ticks += increment;
+	#else
 	// encoder has generated a pulse
 	// check the relative phase of the input channels
 	// and update position accordingly
+	#if ENCODER_FAST_RETUNE						// Write encoder frequency changes without delay
+	if (enc_ticks == 0) enc_firsttime = TCNT1;
+	#endif
 	if(((ENC_A_PORTIN & ENC_A_PIN) == 0) ^ ((ENC_B_PORTIN & ENC_B_PIN) == 0))
 	{
-		increment++;							// Increment
+		enc_ticks++;							// Increment
 	}
 	else
 	{
-		increment--;							// Decrement
+		enc_ticks--;							// Decrement
 	}
+	#endif
 
-	#if ENCODER_FAST_ENABLE						// Feature for variable speed Rotary Encoder
+	#if ENCODER_FAST_ENABLE || ENCODER_ACCEL	// Variable speed Rotary Encoder feature
+	enc_ticktime = TCNT1;						// Time of this pulse, in units of 1/62500 s (16us)
+	#endif
+}
+
+#if ENCODER_ACCEL								// Velocity based acceleration curve
+//
+// Number of significant bits in a 16 bit value, in a fixed number of steps
+//
+static uint8_t enc_bits(uint16_t x)
+{
+	uint8_t	bits = 0;
+
+	if (x & 0xff00) { bits += 8; x >>= 8; }
+	if (x & 0x00f0) { bits += 4; x >>= 4; }
+	if (x & 0x000c) { bits += 2; x >>= 2; }
+	if (x & 0x0002) { bits += 1; x >>= 1; }
+	return bits + x;
+}
+#endif
+
+//
+// Fetch the encoder ticks accumulated by the interrupt handler and apply
+// them to the VFO frequency.  Called from the mainloop as often as possible.
+//
+void encoder_update(void)
+{
+	int16_t			increment;					// Encoder ticks since last time
+	int32_t			step;						// Ticks times the click multiplier
+	#if ENCODER_FAST_RETUNE						// Write encoder frequency changes without delay
+	uint16_t		first_time;					// Time of the first of these ticks
+	#endif
+
+	#if ENCODER_ACCEL							// Velocity based acceleration curve
+	uint16_t		enc_time;					// Time of the last encoder pulse
+	static uint16_t	enc_last;					// Measure the time elapsed since the last encoder pulse
+	uint16_t		clicks;						// Number of encoder ticks, regardless of direction
+	int8_t			speed;						// Index into the acceleration curve
+	static uint8_t	enc_idle = 1;				// No pulse for ENC_ACCEL_IDLE, slow movement
+	#elif ENCODER_FAST_ENABLE					// Variable speed Rotary Encoder feature
+	uint16_t		enc_time;					// Time of the last encoder pulse
+	static uint16_t	enc_last;					// Measure the time elapsed since the last encoder pulse
+	static uint8_t	fast_counter=0;				// Number of rapid movements in succession
+	uint16_t		clicks;						// Number of encoder ticks, regardless of direction
+	#if ENCODER_DIR_SENSE						// Direction change sense.  Used with variable speed feature.
+	static int8_t	direction;					// Direction of last encoder pulse
+	int8_t			dir;						// Direction of this batch of pulses
+	#endif
+	#endif
+
+	cli();										// Keep interrupts off only while swapping out
+	increment = enc_ticks;
+	enc_ticks = 0;
+	#if ENCODER_FAST_ENABLE || ENCODER_ACCEL
+	enc_time = enc_ticktime;
+	#endif
+	#if ENCODER_FAST_RETUNE
+	first_time = enc_firsttime;
+	#endif
+	sei();
+
+	if (increment == 0)							// No encoder activity
+	{
+		#if ENCODER_ACCEL						// Timer1 wraps every ~1.05s, a pause is caught
+		if ((uint16_t)(TCNT1 - enc_last) >= ENC_ACCEL_IDLE)// here, well before the time
+			enc_idle = 1;						// since the last pulse can wrap around
+		#endif
+		return;
+	}
+
+	#if ENCODER_FAST_RETUNE						// Write encoder frequency changes without delay
+	if (!enc_is_pending)						// Latency is measured from the oldest pulse
+	{											// not yet written to the Si570
+		enc_pending = first_time;
+		enc_is_pending = 1;
+	}
+	#endif
+
+	#if	ENCODER_DIR_REVERSE
+	increment = -increment;
+	#endif
+
+	#if ENCODER_ACCEL							// Velocity based acceleration curve
+	//
+	// Acceleration, look up the click multiplier from the time per encoder pulse.
+	// The curve is indexed by the number of significant bits of that time, when
+	// several pulses have accumulated the time is divided down by their number
+	//
+	clicks = (increment > 0) ? increment : -increment;
+	if (enc_idle) speed = ENC_ACCEL_STEPS;		// First pulse after a pause, slow movement
+	else speed = enc_bits((uint16_t)(enc_time - enc_last)) - enc_bits(clicks) + 1;// Modulo 2^16
+	enc_last = enc_time;						// Store for next time measurement
+	enc_idle = 0;
+
+	if (speed < 0) speed = 0;
+	else if (speed >= ENC_ACCEL_STEPS) speed = ENC_ACCEL_STEPS - 1;
+
+	// In 32 bits, enough ticks can pile up during a long LCD, I2C or EEPROM pass
+	// to overflow 16 bits at the higher multipliers
+	step = (int32_t)increment * R.Enc_Accel[speed];
+
+	#elif ENCODER_FAST_ENABLE					// Feature for variable speed Rotary Encoder
 	//
 	// Variable speed function
 	//
+	clicks = (increment > 0) ? increment : -increment;
 
-	// Measure the time since last encoder activity in units of appr 1/65536 seconds
-	enc_time=TCNT1;
+	// Measure the time since last encoder activity in units of 1/62500 s (16us)
+	// Several ticks may have accumulated, each of them is allowed the fast sense time
 	if (enc_last > enc_time); 					// Timer overrun, it is code efficient to do nothing
 	#if ENCODER_RESOLUTION
-	else if (enc_fast_sense >= (enc_time-enc_last)) fast_counter++;// Fast movement detected
+	else if ((uint32_t) enc_fast_sense*clicks >= (enc_time-enc_last))// Fast movement detected
 	#else
-	else if (ENC_FAST_SENSE >= (enc_time-enc_last)) fast_counter++;// Fast movement detected
+	else if ((uint32_t) ENC_FAST_SENSE*clicks >= (enc_time-enc_last))// Fast movement detected
 	#endif
+		fast_counter = (fast_counter + clicks > 255) ? 255 : fast_counter + clicks;
 	else fast_counter = 0;						// Slow movement, reset counter
 	enc_last = enc_time;						// Store for next time measurement
 
@@ -147,7 +303,8 @@ ISR(ENC_A_SIGNAL)
 	#endif	
 		#if ENCODER_DIR_SENSE					// Direction change sense.  Used with variable speed feature.
 		// If direction has changed, force a drop out of FAST mode
-		if (direction != increment)
+		dir = (increment > 0) ? 1 : -1;
+		if (direction != dir)
 		{
 			if (Status2 & ENC_DIR)	Status2 &= ~ENC_DIR;// Previous change was just a one shot event, clear flag
 			else Status2 |= ENC_DIR;					// This is the first event in a new direction, set flag
@@ -158,46 +315,76 @@ ISR(ENC_A_SIGNAL)
 			Status2 = Status2 & ~ENC_FAST & ~ENC_DIR;
 		}
 		
-		direction = increment;					// Save encoder direction for next time
+		direction = dir;						// Save encoder direction for next time
 		#endif
 
 	// When fast mode, multiply the increments by the set MULTIPLY factor
 	if (Status2 & ENC_FAST)	increment = increment * ENC_FAST_MULTIPLY;
-
-	// This one could just as well be outside of the parental if sentence
-	#if ENCODER_CMD_INCR						// USB Command to modify Encoder Resolution
-	R.Freq[0] += increment*R.Encoder_Resolution;// Add or subtract VFO frequency
-	#elif ENCODER_RESOLUTION
-	R.Freq[0] += (int32_t) increment*encoder_resolution;// Add or subtract VFO frequency
+	step = increment;
 	#else
-	R.Freq[0] += increment*ENC_INCREMENTS;		// Add or subtract VFO frequency
+	step = increment;
 	#endif
 
-	#else										// Not Variable speed function
 	#if ENCODER_CMD_INCR						// USB Command to modify Encoder Resolution
-	#if	ENCODER_DIR_REVERSE
-	R.Freq[0] -= increment*R.Encoder_Resolution;// Add or subtract VFO frequency
-	#else
-	R.Freq[0] += increment*R.Encoder_Resolution;// Add or subtract VFO frequency
-	#endif
+	R.Freq[0] += step*R.Encoder_Resolution;		// Add or subtract VFO frequency
 	#elif ENCODER_RESOLUTION
-	#if	ENCODER_DIR_REVERSE
-	R.Freq[0] -= (int32_t) increment*encoder_resolution;// Add or subtract VFO frequency
+	R.Freq[0] += step*encoder_resolution;		// Add or subtract VFO frequency
 	#else
-	R.Freq[0] += (int32_t) increment*encoder_resolution;// Add or subtract VFO frequency
+	R.Freq[0] += step*ENC_INCREMENTS;			// Add or subtract VFO frequency
 	#endif
-	#else
-	#if	ENCODER_DIR_REVERSE
-	R.Freq[0] -= increment*ENC_INCREMENTS;		// Add or subtract VFO frequency
-	#else
-	R.Freq[0] += increment*ENC_INCREMENTS;		// Add or subtract VFO frequency
+
+	#if ENCODER_FAST_RETUNE						// Write encoder frequency changes without delay
+	Status2 |= (ENC_NEWFREQ | ENC_CHANGE);		// Frequency was modified, ENC_CHANGE used by
+	#else										// the variable speed activity watchdog
+	Status2 |= ENC_NEWFREQ;						// Frequency was modified
 	#endif
+}
+
+#if ENCODER_FAST_RETUNE							// Write encoder frequency changes without delay
+//
+// Called from the mainloop after a write to the Si570.  Measures the time
+// since the oldest encoder pulse which was not yet written, in units of 16us
+//
+void encoder_retuned(void)
+{
+	uint16_t	latency;
+
+	if (!enc_is_pending) return;				// Frequency was not changed by the encoder
+
+	latency = TCNT1 - enc_pending;
+	enc_is_pending = 0;
+	enc_latency[0] = latency;					// Last latency
+	if (latency > enc_latency[1]) enc_latency[1] = latency;// Max latency
+}
+#endif
+
+#if ENCODER_RESOLUTION
+//
+// Derive the encoder scaling constants from the number of Resolvable States
+// per Revolution.  Called at init and whenever Cmd 0x67 or Cmd 0x36 modify
+// the resolution, rather than dividing on every encoder pulse.
+//
+void encoder_resolution_update(void)
+{
+	#if ENCODER_CMD_INCR						// USB Command to modify Encoder Resolution
+	if (Status2 & ENC_RES)						// If resolution has been modified by Cmd 0x36
+	{
+		#if ENCODER_FAST_ENABLE
+		enc_fast_sense = ENC_FAST_SENSE;
+		enc_fast_trig = ENC_FAST_TRIG;
+		#endif
+		return;
+	}
+	R.Encoder_Resolution = 8388/R.Resolvable_States;
+	#else
+	encoder_resolution = 8388/R.Resolvable_States;
 	#endif
+	#if ENCODER_FAST_ENABLE
+	enc_fast_sense = 96000/R.Resolvable_States;
+	enc_fast_trig = R.Resolvable_States/5;
 	#endif
-
-	Status2 |= ENC_NEWFREQ;						// Frequency was modified
-	
 }
+#endif
 #endif//ENCODER_INT_STYLE						// Interrupt driven Shaft Encoder
 
 //***********************************************************************************
@@ -298,7 +485,7 @@ void encoder_scan(void)
 	{
 		Status2 &= ~ENC_CHANGE;					// Clear activity flag
 
-		// Measure the time since last encoder activity in units of appr 1/65536 seconds
+		// Measure the time since last encoder activity in units of 1/62500 s (16us)
 		enc_time=TCNT1;
 		if (enc_last > enc_time); 				// Timer overrun, it is code efficient to do nothing
 		#if ENCODER_RESOLUTION
@@ -102,14 +102,30 @@ USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor =
 			.InterfaceNumber        = 0,
 			.AlternateSetting       = 0,
 			
+			#if USB_TELEMETRY							// Interrupt IN endpoint telemetry stream
+			.TotalEndpoints         = 1,
+			#else
 			.TotalEndpoints         = 0,
+			#endif
 				
 			.Class                  = 0x00,
 			.SubClass               = 0x00,
 			.Protocol               = 0x00,
 				
 			.InterfaceStrIndex      = NO_DESCRIPTOR
+		},
+
+	#if USB_TELEMETRY									// Interrupt IN endpoint telemetry stream
+	.TelemetryEndpoint = 
+		{
+			.Header                 = {.Size = sizeof(USB_Descriptor_Endpoint_t), .Type = DTYPE_Endpoint},
+
+			.EndpointAddress        = (ENDPOINT_DESCRIPTOR_DIR_IN | TELEMETRY_EPNUM),
+			.Attributes             = EP_TYPE_INTERRUPT,
+			.EndpointSize           = TELEMETRY_EPSIZE,
+			.PollingIntervalMS      = 0x0A
 		}
+	#endif
 };
 
 
@@ -49,6 +49,8 @@
 		#include <LUFA/Drivers/USB/USB.h>
 
 		#include <avr/pgmspace.h>
+
+		#include "Mobo.h"							// Feature selection (USB_TELEMETRY)
 			 
 
 	/* Type Defines: */
@@ -60,6 +62,9 @@
 		{
 			USB_Descriptor_Configuration_Header_t    Config;
 			USB_Descriptor_Interface_t               Interface;
+			#if USB_TELEMETRY							// Interrupt IN endpoint telemetry stream
+			USB_Descriptor_Endpoint_t                TelemetryEndpoint;
+			#endif
 		} USB_Descriptor_Configuration_t;
 
 	/* Function Prototypes: */
@@ -64,10 +64,52 @@ void Initialize_USB(void)
 	{
 		maintask();		// Start up the Mobo runtime stuff
 		USB_USBTask();	// Start up the USB works
+		#if USB_TELEMETRY
+		Telemetry_Task();	// Send telemetry record, if the host is ready for it
+		#endif
 	}
 }
 
 
+#if USB_TELEMETRY
+//-----------------------------------------------------------------------------------------
+//	Event handler for the USB_ConfigurationChanged event
+//
+//	Set up the interrupt IN endpoint for the telemetry stream
+//-----------------------------------------------------------------------------------------
+void EVENT_USB_Device_ConfigurationChanged(void)
+{
+	Endpoint_ConfigureEndpoint(TELEMETRY_EPNUM, EP_TYPE_INTERRUPT, ENDPOINT_DIR_IN,
+								TELEMETRY_EPSIZE, ENDPOINT_BANK_SINGLE);
+}
+
+
+//-----------------------------------------------------------------------------------------
+//	Send the telemetry record prepared by maintask(), on the interrupt IN endpoint
+//
+//	Only the newest record is sent, if the host does not poll the endpoint
+//	then the record is simply overwritten by the next one
+//-----------------------------------------------------------------------------------------
+void Telemetry_Task(void)
+{
+	if (!telemetry_ready || (USB_DeviceState != DEVICE_STATE_Configured))
+	  return;
+
+	Endpoint_SelectEndpoint(TELEMETRY_EPNUM);
+
+	if (Endpoint_IsINReady())										// Previous record has been picked up
+	{
+		// Write one byte at a time, less costly than Endpoint_Write_Stream_LE()
+		for (uint8_t i=0;i<sizeof(telemetry);i++) Endpoint_Write_Byte(((uint8_t *) &telemetry)[i]);
+		Endpoint_ClearIN();											// Send the record
+		telemetry_ready = False;
+	}
+
+	Endpoint_SelectEndpoint(ENDPOINT_CONTROLEP);
+}
+#endif
+
+
 
 //-----------------------------------------------------------------------------------------
 //	Event handler for the USB_UnhandledControlPacket event
@@ -86,6 +128,30 @@ void EVENT_USB_Device_UnhandledControlRequest(void)
 	{
     	Endpoint_ClearSETUP();										// Clear for reception of data payload
 
+		#if USB_BATCH_CMD || USB_HOP_LIST							// Batch of sub-commands, or hop list load
+		// The batch command (0x38) and the hop list load (0x4a) carry more than one 8 byte
+		// packet, read all packets of the data payload.  A payload larger than BUFFER_SIZE
+		// is thrown away
+		uint16_t received = 0;
+		while (received < USB_ControlRequest.wLength)
+		{
+			while (!Endpoint_IsOUTReceived())						// Wait for packet before attempting to read it
+			{
+			}
+
+			uint8_t n = Endpoint_BytesInEndpoint();
+			for (uint8_t i=0;i<n;i++,received++)
+			{
+				uint8_t c = Endpoint_Read_Byte();
+				if (received<BUFFER_SIZE) dataReceived[received] = c;
+			}
+			Endpoint_ClearOUT();									// Done with packet, clear endpoint
+
+			if (n < FIXED_CONTROL_ENDPOINT_SIZE)					// Short packet, end of payload
+			  break;
+		}
+		replyLen = (received<=BUFFER_SIZE) ? received : 0;
+		#else
 		while (!Endpoint_IsOUTReceived())							// Wait for packet before attempting to read it
 		{
 		//	if (USB_DeviceState == DEVICE_STATE_Unattached)
@@ -104,6 +170,7 @@ void EVENT_USB_Device_UnhandledControlRequest(void)
 		}
 
 		Endpoint_ClearOUT();										// Done with data, clear endpoint, discard
+		#endif
 		// Wait until the host is ready to receive the request confirmation
 		// Appears not to be necessary
 		//while (!(Endpoint_IsINReady()))
@@ -57,16 +57,7 @@
 
 	/* Type Defines: */
 
-	typedef struct
-	{
-		uint8_t  NotificationType; /**< Notification type, a mask of REQDIR_*, REQTYPE_* and REQREC_* constants
-	    	                        *   from the library StdRequestType.h header
-	        	                    */
-		uint8_t  Notification; /**< Notification value, a NOTIF_* constant */
-		uint16_t wValue; /**< Notification wValue, notification-specific */
-		uint16_t wIndex; /**< Notification wIndex, notification-specific */
-		uint16_t wLength; /**< Notification wLength, notification-specific */
-	} USB_Notification_Header_t;
+	// USB_Notification_Header_t is shared with Mobo.h, which is included through USB-Descriptors.h
 
 
 	/* Global Variables: */
@@ -75,6 +66,11 @@
 	// This function, in USB-EP0.c, when called, starts the USB works
 	void Initialize_USB(void);
 
+	#if USB_TELEMETRY
+	// Send the telemetry record on the interrupt IN endpoint
+	void Telemetry_Task(void);
+	#endif
+
 
 	/* External function prototypes */
 	// The three all important functions in Mobo, hooks from the USB works
@@ -30,6 +30,7 @@
 #include <inttypes.h>
 #include <avr/io.h>
 #include <avr/pgmspace.h>
+#include <string.h>
 
 #include "Mobo.h"
 #if LCD_PAR_DISPLAY || LCD_PAR_DISPLAY2
@@ -90,6 +91,39 @@
 static void toggle_e(void);
 #endif
 
+
+#if LCD_FRAMEBUFFER
+/*
+** frame buffer, the display routines write into lcd_fb[] and lcd_flush()
+** sends the characters which differ from what the LCD is showing
+*/
+#define LCD_FB_SIZE     (LCD_LINES*LCD_DISP_LENGTH)
+#define LCD_FB_BITS     ((LCD_FB_SIZE+7)/8)
+
+#define LCD_FB_DIRTY    0x01    /* lcd_fb[] has characters not yet sent     */
+#define LCD_FB_CLEAR    0x02    /* lcd_clrscr(), blank what is not redrawn  */
+#define LCD_FB_CGRAM    0x04    /* lcd_data() writes go to CG RAM           */
+#define LCD_FB_CURSOR   0x08    /* cursor or blinking block shown           */
+#define LCD_FB_CTRL     0x10    /* lcd_fb_ctrl not yet sent                 */
+
+static uint8_t lcd_fb[LCD_FB_SIZE];         /* display image, line by line  */
+static uint8_t lcd_fb_dirty[LCD_FB_BITS];   /* characters not yet sent      */
+static uint8_t lcd_fb_drawn[LCD_FB_BITS];   /* characters written since the
+                                               last lcd_clrscr()            */
+static uint8_t lcd_fb_x, lcd_fb_y;          /* cursor, x==LCD_DISP_LENGTH
+                                               when past the end of a line  */
+static uint8_t lcd_fb_hw;                   /* LCD address counter, 0xff
+                                               when not known               */
+static uint8_t lcd_fb_flags;
+static uint8_t lcd_fb_scan;                 /* where to look for the next
+                                               character to send            */
+#if LCD_BACKGROUND
+static uint8_t lcd_fb_ctrl;                 /* display on/off control       */
+static uint16_t lcd_fb_time;                /* TCNT1 at the oldest change
+                                               not yet sent                 */
+#endif
+#endif
+
 /*
 ** local functions
 */
@@ -350,6 +384,75 @@ static inline void lcd_newline(uint8_t pos)
 }/* lcd_newline */
 
 
+/*************************************************************************
+Send a command or a data byte to the LCD controller
+*************************************************************************/
+static void lcd_send(uint8_t data, uint8_t rs)
+{
+    lcd_waitbusy();
+    lcd_write(data,rs);
+}
+
+
+#if LCD_FRAMEBUFFER
+/*************************************************************************
+DDRAM address of the first character of line y
+*************************************************************************/
+static uint8_t lcd_fb_line(uint8_t y)
+{
+#if LCD_LINES==1
+    return LCD_START_LINE1;
+#endif
+#if LCD_LINES==2
+    return y ? LCD_START_LINE2 : LCD_START_LINE1;
+#endif
+#if LCD_LINES==4
+    if ( y==0 )
+        return LCD_START_LINE1;
+    else if ( y==1 )
+        return LCD_START_LINE2;
+    else if ( y==2 )
+        return LCD_START_LINE3;
+    else /* y==3 */
+        return LCD_START_LINE4;
+#endif
+}
+
+
+/*************************************************************************
+Move the frame buffer cursor to a DDRAM address
+*************************************************************************/
+static void lcd_fb_seek(uint8_t addr)
+{
+    uint8_t y;
+
+    for (y=0; y<LCD_LINES; y++)
+    {
+        if ( (uint8_t)(addr - lcd_fb_line(y)) < LCD_DISP_LENGTH )
+        {
+            lcd_fb_x = addr - lcd_fb_line(y);
+            lcd_fb_y = y;
+            return;
+        }
+    }
+    lcd_fb_x = LCD_DISP_LENGTH;                 /* not visible, drop writes */
+}
+
+
+/*************************************************************************
+Mark a change for lcd_flush()
+*************************************************************************/
+static void lcd_fb_mark(uint8_t flag)
+{
+#if LCD_BACKGROUND
+    if ( !(lcd_fb_flags & (LCD_FB_DIRTY|LCD_FB_CTRL)) )
+        lcd_fb_time = TCNT1;
+#endif
+    lcd_fb_flags |= flag;
+}
+#endif
+
+
 /*
 ** PUBLIC FUNCTIONS 
 */
@@ -361,8 +464,47 @@ Returns: none
 *************************************************************************/
 void lcd_command(uint8_t cmd)
 {
-    lcd_waitbusy();
-    lcd_write(cmd,0);
+#if LCD_FRAMEBUFFER
+    if (cmd & (1<<LCD_DDRAM))                   /* set cursor, in lcd_fb[]  */
+    {
+        lcd_fb_seek(cmd & ~(1<<LCD_DDRAM));
+        lcd_fb_flags &= ~LCD_FB_CGRAM;
+        return;
+    }
+    if (cmd & (1<<LCD_CGRAM))                   /* custom characters        */
+    {
+        lcd_fb_flags |= LCD_FB_CGRAM;
+        lcd_fb_hw = 0xff;
+    }
+    else if ( (cmd & ~0x07) == LCD_DISP_OFF )   /* display on/off control   */
+    {
+        if (cmd & 0x03)
+            lcd_fb_flags |= LCD_FB_CURSOR;
+        else
+            lcd_fb_flags &= ~LCD_FB_CURSOR;
+#if LCD_BACKGROUND
+        lcd_fb_ctrl = cmd;
+        lcd_fb_mark(LCD_FB_CTRL);
+        return;
+#endif
+    }
+    else if (cmd < (1<<LCD_ENTRY_MODE))         /* clear display and home   */
+    {
+        if (cmd == (1<<LCD_CLR))
+        {
+            /*
+             * Not sent, the display routines redraw most of the display after
+             * a clear.  lcd_flush() blanks the characters which are not redrawn
+             */
+            memset(lcd_fb_drawn, 0, LCD_FB_BITS);
+            lcd_fb_flags |= LCD_FB_CLEAR;
+        }
+        lcd_fb_x = lcd_fb_y = 0;
+        lcd_fb_flags &= ~LCD_FB_CGRAM;
+        return;
+    }
+#endif
+    lcd_send(cmd,0);
 }
 
 
@@ -373,8 +515,28 @@ Returns: none
 *************************************************************************/
 void lcd_data(uint8_t data)
 {
-    lcd_waitbusy();
-    lcd_write(data,1);
+#if LCD_FRAMEBUFFER
+    uint8_t i, bit;
+
+
+    if ( !(lcd_fb_flags & LCD_FB_CGRAM) )
+    {
+        if (lcd_fb_x < LCD_DISP_LENGTH)
+        {
+            i = lcd_fb_y*LCD_DISP_LENGTH + lcd_fb_x++;
+            bit = 1 << (i & 7);
+            lcd_fb_drawn[i>>3] |= bit;
+            if (lcd_fb[i] != data)
+            {
+                lcd_fb[i] = data;
+                lcd_fb_dirty[i>>3] |= bit;
+                lcd_fb_mark(LCD_FB_DIRTY);
+            }
+        }
+        return;
+    }
+#endif
+    lcd_send(data,1);
 }
 
 
@@ -387,6 +549,11 @@ Returns:  none
 *************************************************************************/
 void lcd_gotoxy(uint8_t x, uint8_t y)
 {
+#if LCD_FRAMEBUFFER
+    lcd_fb_x = (x < LCD_DISP_LENGTH) ? x : LCD_DISP_LENGTH;
+    lcd_fb_y = (y < LCD_LINES) ? y : LCD_LINES-1;
+    lcd_fb_flags &= ~LCD_FB_CGRAM;
+#else
 #if LCD_LINES==1
     lcd_command((1<<LCD_DDRAM)+LCD_START_LINE1+x);
 #endif
@@ -406,6 +573,7 @@ void lcd_gotoxy(uint8_t x, uint8_t y)
     else /* y==3 */
         lcd_command((1<<LCD_DDRAM)+LCD_START_LINE4+x);
 #endif
+#endif
 
 }/* lcd_gotoxy */
 
@@ -414,7 +582,11 @@ void lcd_gotoxy(uint8_t x, uint8_t y)
 *************************************************************************/
 int lcd_getxy(void)
 {
+#if LCD_FRAMEBUFFER
+    return lcd_fb_line(lcd_fb_y) + lcd_fb_x;
+#else
     return lcd_waitbusy();
+#endif
 }
 
 
@@ -443,6 +615,16 @@ Returns:  none
 *************************************************************************/
 void lcd_putc(char c)
 {
+#if LCD_FRAMEBUFFER
+    if (c=='\n')
+    {
+        lcd_fb_x = 0;
+        if (++lcd_fb_y >= LCD_LINES)
+            lcd_fb_y = 0;
+    }
+    else
+        lcd_data(c);
+#else
     uint8_t pos;
 
 
@@ -479,6 +661,7 @@ void lcd_putc(char c)
 #endif
         lcd_write(c, 1);
     }
+#endif
 
 }/* lcd_putc */
 
@@ -534,6 +717,128 @@ void lcd_puts_p(const char *progmem_s)
 }/* lcd_puts_p */
 
 
+#if LCD_FRAMEBUFFER
+/*************************************************************************
+Send the next command or character of the frame buffer to the LCD
+Input:    wait   1: wait until the LCD is not busy
+                 0: do not send anything while the LCD is busy
+Returns:  0 when the LCD is up to date
+*************************************************************************/
+static uint8_t lcd_fb_step(uint8_t wait)
+{
+    uint8_t i, n, addr, c;
+
+
+#if LCD_BACKGROUND
+    if (lcd_fb_flags & LCD_FB_CTRL)
+        addr = lcd_fb_hw;                       /* no cursor move needed    */
+    else
+#endif
+    if (lcd_fb_flags & LCD_FB_DIRTY)
+    {
+        /* next changed character, from where the last one was found */
+        i = lcd_fb_scan;
+        for (n=LCD_FB_SIZE; n; n--, i++)
+        {
+            if (i >= LCD_FB_SIZE)
+                i = 0;
+            if (lcd_fb_dirty[i>>3] & (1 << (i & 7)))
+                break;
+        }
+        if (n)
+        {
+            lcd_fb_scan = i;
+            addr = lcd_fb_line(i/LCD_DISP_LENGTH) + i%LCD_DISP_LENGTH;
+        }
+        else
+            lcd_fb_flags &= ~LCD_FB_DIRTY;
+    }
+
+    if ( !(lcd_fb_flags & (LCD_FB_DIRTY|LCD_FB_CTRL)) )
+    {
+        /* leave a visible cursor where the display routines left it */
+        if ( !(lcd_fb_flags & LCD_FB_CURSOR) || (lcd_fb_x >= LCD_DISP_LENGTH) )
+            return 0;
+        addr = lcd_fb_line(lcd_fb_y) + lcd_fb_x;
+        if (addr == lcd_fb_hw)
+            return 0;
+    }
+
+    if (wait)
+        lcd_waitbusy();
+    else
+    {
+        c = lcd_read(0);
+        if (c & (1<<LCD_BUSY))
+            return 1;
+    }
+
+    if (addr != lcd_fb_hw)                      /* move only to skip a run  */
+    {
+        lcd_write((1<<LCD_DDRAM)+addr,0);
+        lcd_fb_hw = addr;
+    }
+#if LCD_BACKGROUND
+    else if (lcd_fb_flags & LCD_FB_CTRL)
+    {
+        lcd_write(lcd_fb_ctrl,0);
+        lcd_fb_flags &= ~LCD_FB_CTRL;
+    }
+#endif
+    else
+    {
+        i = lcd_fb_scan++;
+        lcd_write(lcd_fb[i],1);
+        lcd_fb_dirty[i>>3] &= ~(1 << (i & 7));
+        lcd_fb_hw = addr + 1;
+    }
+    return 1;
+}
+
+
+/*************************************************************************
+Send the characters of the frame buffer which have changed, called once
+per pass of maintask().  With LCD_BACKGROUND, one command or character is
+sent, if the LCD is not busy, unless there are changes which have waited
+for more than LCD_FLUSH_DEADLINE
+Input:    none
+Returns:  none
+*************************************************************************/
+void lcd_flush(void)
+{
+    uint8_t i, bit;
+
+
+    if (lcd_fb_flags & LCD_FB_CLEAR)            /* blank what was not redrawn */
+    {
+        lcd_fb_flags &= ~LCD_FB_CLEAR;
+        for (i=0; i<LCD_FB_SIZE; i++)
+        {
+            bit = 1 << (i & 7);
+            if ( !(lcd_fb_drawn[i>>3] & bit) && (lcd_fb[i] != ' ') )
+            {
+                lcd_fb[i] = ' ';
+                lcd_fb_dirty[i>>3] |= bit;
+                lcd_fb_mark(LCD_FB_DIRTY);
+            }
+        }
+    }
+
+#if LCD_BACKGROUND
+    /* Timer1 runs at 62500 Hz */
+    if ( !(lcd_fb_flags & (LCD_FB_DIRTY|LCD_FB_CTRL))
+      || ((uint16_t)(TCNT1 - lcd_fb_time) < LCD_FLUSH_DEADLINE*125U/2) )
+    {
+        lcd_fb_step(0);
+        return;
+    }
+#endif
+    while (lcd_fb_step(1));
+
+}/* lcd_flush */
+#endif
+
+
 /*************************************************************************
 Initialize display and select type of cursor 
 Input:    dispAttr LCD_DISP_OFF            display off
@@ -662,6 +967,14 @@ void lcd_init(uint8_t dispAttr)
     //lcd_command(LCD_MODE_DEFAULT);          /* set entry mode               */
     //lcd_command(dispAttr);                  /* display/cursor control       */
 
+#if LCD_FRAMEBUFFER
+    /* contents of the LCD not known, send all of the frame buffer */
+    memset(lcd_fb, ' ', LCD_FB_SIZE);
+    memset(lcd_fb_dirty, 0xff, LCD_FB_BITS);
+    lcd_fb_flags = LCD_FB_DIRTY;
+    lcd_fb_hw = 0xff;
+#endif
+
 }/* lcd_init */
 
 #endif
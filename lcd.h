@@ -267,6 +267,19 @@ extern void lcd_command(uint8_t cmd);
 extern void lcd_data(uint8_t data);
 
 
+#if LCD_FRAMEBUFFER
+/**
+ @brief    Send the characters which have changed to the LCD
+ 
+ With LCD_FRAMEBUFFER, the other functions write into a RAM image of the
+ display, which is sent to the LCD by this function
+ @param    none
+ @return   none
+*/
+extern void lcd_flush(void);
+#endif
+
+
 /**
  @brief macros for automatically storing string constant in program memory
 */
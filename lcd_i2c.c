@@ -24,6 +24,101 @@ void lcd_i2c_address_init(uint8_t new_addr)
 	Status1 &= ~I2C_BUSY;			// Indicate I2C port is free
 }
 
+
+#if LCD_I2C_BATCH
+//
+// The LCD bytes, characters and commands with their arguments, are collected in
+// lcd_i2c_buf[], and sent in one I2C transaction by lcd_flush().  All I2C traffic
+// is done by the mainloop, so no I2C busy flag is needed.  The LCD cursor is
+// followed, so that cursor commands which do not move the cursor are not sent
+//
+static uint8_t	lcd_i2c_buf[LCD_I2C_BUF];	// Bytes not yet sent
+static uint8_t	lcd_i2c_len;				// Number of bytes in lcd_i2c_buf[]
+static uint8_t	lcd_i2c_goto;				// lcd_i2c_len just after the last set cursor command,
+											// 0 = none in lcd_i2c_buf[]
+static uint8_t	lcd_i2c_cursor = 0xff;		// LCD cursor, after the bytes in lcd_i2c_buf[], 0xff = unknown
+
+// Send the collected bytes, called at the end of maintask(), or when lcd_i2c_buf[] is full
+void lcd_flush(void)
+{
+	uint8_t i;
+
+	if (!lcd_i2c_len) return;
+
+	I2CSendStart();
+	I2CSendByte(LCD_I2C_ADDRESS<<1);
+	for (i = 0; i < lcd_i2c_len; i++)
+		I2CSendByte(lcd_i2c_buf[i]);// send data and commands
+	I2CSendStop();
+
+	lcd_i2c_len = 0;
+	lcd_i2c_goto = 0;
+}
+
+// Make room for n bytes, a command and its arguments are sent in the same transaction
+static void lcd_i2c_room(uint8_t n)
+{
+	if (lcd_i2c_len + n > LCD_I2C_BUF) lcd_flush();
+}
+
+static void lcd_i2c_cmd(uint8_t cmd)
+{
+	lcd_i2c_room(2);
+	lcd_i2c_buf[lcd_i2c_len++] = LCD_I2C_COMMAND;
+	lcd_i2c_buf[lcd_i2c_len++] = cmd;
+}
+
+void lcd_puts(char *string)
+{
+	while (*string)
+		lcd_data(*string++);
+}
+
+void lcd_data(uint8_t c)
+{
+	lcd_i2c_room(1);
+	lcd_i2c_buf[lcd_i2c_len++] = c;
+	if (lcd_i2c_cursor != 0xff) lcd_i2c_cursor++;
+}
+
+void lcd_command(uint8_t cmd)
+{
+	lcd_i2c_cmd(cmd);
+	lcd_i2c_cursor = 0xff;					// The command may have moved the cursor
+}
+
+void lcd_i2c_set_contrast(uint8_t contrast)
+{
+	lcd_i2c_room(3);
+	lcd_i2c_cmd(LCD_I2C_SET_CONTRAST);
+	lcd_i2c_buf[lcd_i2c_len++] = contrast;
+}
+
+void lcd_i2c_clrscr(void)
+{
+	lcd_i2c_cmd(LCD_I2C_CLEAR_SCREEN);
+	lcd_i2c_cursor = 0;
+}
+
+void lcd_gotoxy(uint8_t x, uint8_t y)
+{
+	uint8_t cursor = x + 0x40 * y;
+
+	if (cursor == lcd_i2c_cursor) return;	// Already there
+	lcd_i2c_cursor = cursor;
+
+	if (lcd_i2c_goto && (lcd_i2c_goto == lcd_i2c_len))// Nothing written since the last cursor
+	{										// command, replace its position
+		lcd_i2c_buf[lcd_i2c_len-1] = cursor;
+		return;
+	}
+	lcd_i2c_room(3);
+	lcd_i2c_cmd(LCD_I2C_SET_CURSOR);
+	lcd_i2c_buf[lcd_i2c_len++] = cursor;
+	lcd_i2c_goto = lcd_i2c_len;
+}
+
+#else
 //void lcd_i2c_puts(char *string)
 void lcd_puts(char *string)
 {
@@ -113,4 +208,5 @@ void lcd_gotoxy(uint8_t x, uint8_t y)
 
 	Status1 &= ~I2C_BUSY;			// Indicate I2C port is free
 }
+#endif//LCD_I2C_BATCH
 #endif//LCD_I2C_DISPLAY		// 16x2 I2C connected secondary LCD display
@@ -60,5 +60,8 @@ extern void lcd_data(uint8_t);
 extern void lcd_clrscr(void);
 extern void lcd_gotoxy(uint8_t, uint8_t);
 extern void lcd_i2c_set_contrast(uint8_t);
+#if LCD_I2C_BATCH
+extern void lcd_flush(void);
+#endif
 
 #endif// LCD_I2C_DISPLAY					// 16x2 I2C connected secondary LCD display